@@ -0,0 +1,270 @@
+#pragma once
+/**
+	Description :
+	Adaptive Run-Detecting Merge Sort (Powersort Merge Policy)
+
+	1. Scan for natural runs, strictly descending runs are reversed in
+	   place (strict keeps the sort stable).
+	2. Runs shorter than MIN_RUN are extended with binary insertion sort.
+	3. Runs are merged in the order given by their powersort node power,
+	   which keeps the merge tree within a few percent of optimal for the
+	   detected run lengths.
+	4. Merges trim the parts already in place, buffer only the shorter
+	   run and switch to galloping (exponential search) when one side
+	   keeps winning.
+
+	A sorted or reverse-sorted input is a single run, so it costs n - 1
+	comparisons and no merges. Stable.
+**/
+
+#include <cstdint> // uint64_t
+#include <vector> // std::vector
+#include <iterator> // std::iterator_traits, std::reverse_iterator
+#include <algorithm> // std::upper_bound, std::lower_bound, std::reverse, std::move
+
+#include "VectorCompleteTree.hpp" // Compare
+
+template <class RandomIt, class C>
+void adaptiveSort(RandomIt first, RandomIt last, C isLess);
+
+template <class RandomIt>
+void adaptiveSort(RandomIt first, RandomIt last)
+{
+	adaptiveSort(first, last, Compare<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+
+namespace adaptive_detail {
+
+	const int MIN_RUN = 32;
+	const int MIN_GALLOP = 7;
+
+	// comparator with its arguments swapped, merges backwards through it
+	template <class C>
+	class Flip {
+	public:
+		explicit Flip(C c) : isLess(c) {}
+		template <class T>
+		bool operator () (const T& x, const T& y) const { return isLess(y, x); }
+	private:
+		C isLess;
+	};
+
+	// first p in [first, last) with isLess(key, *p), probing 1, 3, 7, ... from first
+	template <class It, class T, class C>
+	It gallopUpper(It first, It last, const T& key, C isLess)
+	{
+		typename std::iterator_traits<It>::difference_type lo = 0, hi = 1, n = last - first;
+		while (hi < n && !isLess(key, first[hi])) {
+			lo = hi;
+			hi = 2 * hi + 1;
+		}
+		if (hi > n)
+			hi = n;
+		return std::upper_bound(first + lo, first + hi, key, isLess);
+	}
+
+	// first p in [first, last) with !isLess(*p, key), probing 1, 3, 7, ... from first
+	template <class It, class T, class C>
+	It gallopLower(It first, It last, const T& key, C isLess)
+	{
+		typename std::iterator_traits<It>::difference_type lo = 0, hi = 1, n = last - first;
+		while (hi < n && isLess(first[hi], key)) {
+			lo = hi;
+			hi = 2 * hi + 1;
+		}
+		if (hi > n)
+			hi = n;
+		return std::lower_bound(first + lo, first + hi, key, isLess);
+	}
+
+	/*
+		Merge the buffered left run [l, lend) with the in-place right run
+		[r, rend) into dest, which starts where the left run was. Ties go
+		to the left run. Run through reverse iterators and Flip this is the
+		backward merge used when the right run is the shorter one.
+	*/
+	template <class BufIt, class It, class C>
+	void mergeForward(BufIt l, BufIt lend, It r, It rend, It dest, C isLess, int& minGallop)
+	{
+		while (l != lend && r != rend) {
+			int lWins = 0, rWins = 0;
+			// one element at a time until one side keeps winning
+			while (l != lend && r != rend) {
+				if (isLess(*r, *l)) {
+					*dest++ = std::move(*r++);
+					rWins++; lWins = 0;
+					if (rWins >= minGallop) break;
+				}
+				else {
+					*dest++ = std::move(*l++);
+					lWins++; rWins = 0;
+					if (lWins >= minGallop) break;
+				}
+			}
+			if (l == lend || r == rend)
+				break;
+			// galloping, copy whole stretches found by exponential search
+			do {
+				BufIt lcut = gallopUpper(l, lend, *r, isLess);
+				lWins = static_cast<int>(lcut - l);
+				dest = std::move(l, lcut, dest);
+				l = lcut;
+				if (l == lend) break;
+				*dest++ = std::move(*r++);
+				if (r == rend) break;
+
+				It rcut = gallopLower(r, rend, *l, isLess);
+				rWins = static_cast<int>(rcut - r);
+				dest = std::move(r, rcut, dest);
+				r = rcut;
+				if (r == rend) break;
+				*dest++ = std::move(*l++);
+				if (l == lend) break;
+
+				if (minGallop > 1)
+					minGallop--;
+			} while (lWins >= MIN_GALLOP || rWins >= MIN_GALLOP);
+			minGallop += 2; // penalise leaving galloping mode
+		}
+		// the rest of the right run is already in place
+		std::move(l, lend, dest);
+	}
+
+	template <class RandomIt, class C>
+	class Sorter {
+	public:
+		typedef typename std::iterator_traits<RandomIt>::value_type T;
+
+		Sorter(RandomIt first, RandomIt last, C c) : base(first), n(static_cast<uint64_t>(last - first)), isLess(c) {}
+
+		void sort()
+		{
+			if (n < 2)
+				return;
+			std::vector<Run> stack;
+			uint64_t start = 0;
+			Run x = nextRun(start);
+			while (x.start + x.len < n) {
+				Run y = nextRun(x.start + x.len);
+				int p = nodePower(x, y);
+				// merge everything whose boundary sits deeper than x|y
+				while (!stack.empty() && stack.back().power > p) {
+					Run z = stack.back();
+					stack.pop_back();
+					mergeRuns(z, x);
+					x = Run{ z.start, z.len + x.len, z.power };
+				}
+				x.power = p;
+				stack.push_back(x);
+				x = y;
+			}
+			while (!stack.empty()) {
+				Run z = stack.back();
+				stack.pop_back();
+				mergeRuns(z, x);
+				x = Run{ z.start, z.len + x.len, z.power };
+			}
+		}
+	private:
+		struct Run {
+			uint64_t start, len;
+			int power;
+		};
+
+		// natural run at start, reversed if descending, extended to MIN_RUN
+		Run nextRun(uint64_t start)
+		{
+			RandomIt lo = base + start, end = base + n, hi = lo + 1;
+			if (hi != end) {
+				if (isLess(*hi, *lo)) { // strictly descending
+					while (hi + 1 != end && isLess(*(hi + 1), *hi))
+						++hi;
+					++hi;
+					std::reverse(lo, hi);
+				}
+				else {
+					while (hi + 1 != end && !isLess(*(hi + 1), *hi))
+						++hi;
+					++hi;
+				}
+			}
+			uint64_t len = static_cast<uint64_t>(hi - lo);
+			uint64_t want = std::min<uint64_t>(MIN_RUN, n - start);
+			if (len < want) {
+				binaryInsertion(lo, lo + len, lo + want);
+				len = want;
+			}
+			return Run{ start, len, 0 };
+		}
+
+		// [lo, sortedEnd) is sorted, insert the rest of [lo, hi)
+		void binaryInsertion(RandomIt lo, RandomIt sortedEnd, RandomIt hi)
+		{
+			for (RandomIt it = sortedEnd; it != hi; ++it) {
+				RandomIt pos = std::upper_bound(lo, it, *it, isLess);
+				if (pos != it) {
+					T x = std::move(*it);
+					std::move_backward(pos, it, it + 1);
+					*pos = std::move(x);
+				}
+			}
+		}
+
+		// depth of the boundary between adjacent runs in the virtual
+		// perfectly balanced merge tree over [0, n)
+		int nodePower(const Run& a, const Run& b) const
+		{
+			uint64_t l = 2 * a.start + a.len;		// 2 * midpoint of a
+			uint64_t r = 2 * b.start + b.len;		// 2 * midpoint of b
+			uint64_t n2 = 2 * n;
+			int p = 0;
+			for (;;) {
+				p++;
+				l <<= 1;
+				r <<= 1;
+				bool lb = l >= n2, rb = r >= n2;
+				if (lb != rb)
+					return p;
+				if (lb) {
+					l -= n2;
+					r -= n2;
+				}
+			}
+		}
+
+		void mergeRuns(const Run& a, const Run& b)
+		{
+			RandomIt lo = base + a.start, mid = lo + a.len, hi = mid + b.len;
+			// left elements not above the right run's first are in place
+			lo = gallopUpper(lo, mid, *mid, isLess);
+			if (lo == mid)
+				return;
+			// right elements not below the left run's last are in place
+			hi = gallopLower(mid, hi, *(mid - 1), isLess);
+
+			if (mid - lo <= hi - mid) {
+				buffer.assign(std::make_move_iterator(lo), std::make_move_iterator(mid));
+				mergeForward(buffer.begin(), buffer.end(), mid, hi, lo, isLess, minGallop);
+			}
+			else {
+				buffer.assign(std::make_move_iterator(mid), std::make_move_iterator(hi));
+				typedef std::reverse_iterator<RandomIt> RevIt;
+				mergeForward(buffer.rbegin(), buffer.rend(), RevIt(mid), RevIt(lo), RevIt(hi), Flip<C>(isLess), minGallop);
+			}
+		}
+
+		RandomIt base;
+		uint64_t n;
+		C isLess;
+		std::vector<T> buffer;
+		int minGallop = MIN_GALLOP;
+	};
+}
+
+template <class RandomIt, class C>
+void adaptiveSort(RandomIt first, RandomIt last, C isLess)
+{
+	adaptive_detail::Sorter<RandomIt, C> sorter(first, last, isLess);
+	sorter.sort();
+}
@@ -0,0 +1,174 @@
+#pragma once
+/**
+	Description :
+	Addressable d-ary Min Heap (indexed heap with decrease-key)
+
+	insert() returns a Handle that stays valid until the element leaves
+	the heap, through removeMin() or erase(). A handle array maps every
+	handle to the element's current heap slot, so decreaseKey(),
+	increaseKey() and erase() find the element in O(1) and restore the
+	heap in O(log n) instead of pushing a duplicate and skipping stale
+	entries later. Handles of removed elements are reused.
+
+	The heap array is 0-indexed with the children of i at Di + 1 ... Di + D
+	and holds each key next to its handle, so sifting compares without
+	going through the handle array. Sifting moves a hole like
+	HeapPriorityQueue.
+**/
+
+#include <vector> // std::vector
+#include <utility> // std::move
+#include <stdexcept> // std::invalid_argument
+
+#include "VectorCompleteTree.hpp" // Compare
+
+template <class NodeType, class C = Compare<NodeType>, int D = 4>
+class AddressableHeap
+{
+public:
+	typedef int Handle;
+
+	int size() const { return static_cast<int>(heap.size()); }
+	bool empty() const { return heap.empty(); }
+	// true while h refers to an element in the heap
+	bool contains(Handle h) const { return h >= 0 && h < static_cast<Handle>(where.size()) && where[h] >= 0; }
+	const NodeType& key(Handle h) const { return heap[where[h]].key; }
+
+	Handle insert(const NodeType& e);
+	const NodeType& min() const { return heap.front().key; }
+	Handle minHandle() const { return heap.front().handle; }
+	void removeMin() { erase(heap.front().handle); }
+	// e must not be greater than the current key
+	void decreaseKey(Handle h, const NodeType& e);
+	// e must not be smaller than the current key
+	void increaseKey(Handle h, const NodeType& e);
+	// either direction
+	void update(Handle h, const NodeType& e);
+	void erase(Handle h);
+	void clear();
+private:
+	struct Entry {
+		NodeType key;
+		Handle handle;
+	};
+
+	void upHeap(int i, Entry e); // e goes into the hole at i
+	void downHeap(int i, Entry e);
+	void place(int i, Entry&& e)
+	{
+		where[e.handle] = i;
+		heap[i] = std::move(e);
+	}
+	void check(Handle h) const
+	{
+		if (!contains(h))
+			throw std::invalid_argument("Error: handle is not in the heap");
+	}
+
+	std::vector<Entry> heap;
+	std::vector<int> where; // heap slot of every handle, -1 once removed
+	std::vector<Handle> freeHandles;
+	C isLess;
+};
+
+template <class NodeType, class C, int D>
+typename AddressableHeap<NodeType, C, D>::Handle AddressableHeap<NodeType, C, D>::insert(const NodeType& e)
+{
+	Handle h;
+	if (!freeHandles.empty()) {
+		h = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else {
+		h = static_cast<Handle>(where.size());
+		where.push_back(-1);
+	}
+	heap.push_back(Entry{ e, h });
+	upHeap(size() - 1, std::move(heap.back()));
+	return h;
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::decreaseKey(Handle h, const NodeType& e)
+{
+	check(h);
+	if (isLess(heap[where[h]].key, e))
+		throw std::invalid_argument("Error: decreaseKey to a greater key");
+	upHeap(where[h], Entry{ e, h });
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::increaseKey(Handle h, const NodeType& e)
+{
+	check(h);
+	if (isLess(e, heap[where[h]].key))
+		throw std::invalid_argument("Error: increaseKey to a smaller key");
+	downHeap(where[h], Entry{ e, h });
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::update(Handle h, const NodeType& e)
+{
+	check(h);
+	if (isLess(e, heap[where[h]].key))
+		upHeap(where[h], Entry{ e, h });
+	else
+		downHeap(where[h], Entry{ e, h });
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::erase(Handle h)
+{
+	check(h);
+	int i = where[h];
+	where[h] = -1;
+	freeHandles.push_back(h);
+	Entry last = std::move(heap.back()); // last entry refills the hole
+	heap.pop_back();
+	if (i == size())
+		return; // h was the last entry
+	if (i > 0 && isLess(last.key, heap[(i - 1) / D].key))
+		upHeap(i, std::move(last));
+	else
+		downHeap(i, std::move(last));
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::clear()
+{
+	heap.clear();
+	where.clear();
+	freeHandles.clear();
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::upHeap(int i, Entry e)
+{
+	while (i > 0) { // up-heap bubbling
+		int parent = (i - 1) / D;
+		if (!isLess(e.key, heap[parent].key)) break;
+		place(i, std::move(heap[parent]));
+		i = parent;
+	}
+	place(i, std::move(e));
+}
+
+template <class NodeType, class C, int D>
+void AddressableHeap<NodeType, C, D>::downHeap(int i, Entry e)
+{
+	int n = size();
+	for (;;) { // down-heap bubbling
+		int first = D * i + 1;
+		if (first >= n)
+			break;
+		int last = first + D < n ? first + D : n;
+		int best = first; // smallest child
+		for (int j = first + 1; j < last; j++)
+			if (isLess(heap[j].key, heap[best].key))
+				best = j;
+		if (!isLess(heap[best].key, e.key)) break;
+		place(i, std::move(heap[best]));
+		i = best;
+	}
+	place(i, std::move(e));
+}
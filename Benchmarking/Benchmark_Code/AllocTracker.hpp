@@ -0,0 +1,165 @@
+#pragma once
+/**
+	Description :
+	Heap Allocation Accounting for the Benchmarks (opt-in)
+
+	Built with TRACK_ALLOCATIONS defined, this header replaces the global
+	operator new / delete (plain, array, sized and aligned forms) with
+	versions that keep a small size header in front of every block and
+	count allocations, bytes allocated, live bytes and the live-byte peak.
+	Replacement operators cannot be inline, so include this header from
+	exactly one translation unit (the benchmark's Main.cpp).
+
+	Without TRACK_ALLOCATIONS nothing is replaced and available() is false.
+
+	Usage :
+		AllocCounters allocs;
+		allocs.start(); ...build and run the structure... allocs.stop();
+		allocs.allocations(); allocs.bytes(); allocs.peak();
+**/
+
+#include <cstdint> // uint64_t
+#include <cstddef> // size_t, std::max_align_t
+
+#ifdef TRACK_ALLOCATIONS
+#include <atomic> // std::atomic
+#include <cstdlib> // std::malloc, std::free
+#include <new> // std::bad_alloc, std::align_val_t
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc
+#endif
+#endif
+
+namespace alloc_detail {
+
+	struct Totals {
+		uint64_t allocations;
+		uint64_t bytes;		// allocated so far
+		uint64_t current;	// live right now
+		uint64_t peak;		// live high-water mark
+	};
+
+#ifdef TRACK_ALLOCATIONS
+	struct AtomicTotals {
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+		std::atomic<uint64_t> current{ 0 };
+		std::atomic<uint64_t> peak{ 0 };
+	};
+
+	inline AtomicTotals& totals()
+	{
+		static AtomicTotals t; // no allocation, safe to use from operator new
+		return t;
+	}
+
+	inline void recordAlloc(size_t n)
+	{
+		AtomicTotals& t = totals();
+		t.allocations.fetch_add(1, std::memory_order_relaxed);
+		t.bytes.fetch_add(n, std::memory_order_relaxed);
+		uint64_t now = t.current.fetch_add(n, std::memory_order_relaxed) + n;
+		uint64_t peak = t.peak.load(std::memory_order_relaxed);
+		while (now > peak && !t.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+	}
+
+	inline void recordFree(size_t n)
+	{
+		totals().current.fetch_sub(n, std::memory_order_relaxed);
+	}
+
+	// header of `align` bytes in front of the block, size in its last word
+	inline void* allocate(size_t n, size_t align)
+	{
+		if (align < alignof(std::max_align_t))
+			align = alignof(std::max_align_t);
+		size_t total = (n + 2 * align - 1) / align * align; // header + n, rounded
+#ifdef _WIN32
+		char* block = static_cast<char*>(_aligned_malloc(total, align));
+#else
+		char* block = static_cast<char*>(align == alignof(std::max_align_t) ? std::malloc(total) : std::aligned_alloc(align, total));
+#endif
+		if (!block)
+			throw std::bad_alloc();
+		char* user = block + align;
+		reinterpret_cast<size_t*>(user)[-1] = n;
+		reinterpret_cast<size_t*>(user)[-2] = align;
+		recordAlloc(n);
+		return user;
+	}
+
+	inline void release(void* p)
+	{
+		if (!p)
+			return;
+		char* user = static_cast<char*>(p);
+		size_t n = reinterpret_cast<size_t*>(user)[-1];
+		size_t align = reinterpret_cast<size_t*>(user)[-2];
+		recordFree(n);
+#ifdef _WIN32
+		_aligned_free(user - align);
+#else
+		std::free(user - align);
+#endif
+	}
+#endif
+
+	inline Totals snapshot()
+	{
+#ifdef TRACK_ALLOCATIONS
+		AtomicTotals& t = totals();
+		return Totals{ t.allocations.load(), t.bytes.load(), t.current.load(), t.peak.load() };
+#else
+		return Totals{ 0, 0, 0, 0 };
+#endif
+	}
+
+	// restart the high-water mark from the current live bytes
+	inline void resetPeak()
+	{
+#ifdef TRACK_ALLOCATIONS
+		totals().peak.store(totals().current.load());
+#endif
+	}
+}
+
+class AllocCounters
+{
+public:
+#ifdef TRACK_ALLOCATIONS
+	bool available() const { return true; }
+#else
+	bool available() const { return false; }
+#endif
+	void start()
+	{
+		alloc_detail::resetPeak();
+		begin = alloc_detail::snapshot();
+	}
+	void stop() { end = alloc_detail::snapshot(); }
+
+	uint64_t allocations() const { return end.allocations - begin.allocations; }
+	uint64_t bytes() const { return end.bytes - begin.bytes; }
+	// live-byte high-water mark above what was live at start()
+	uint64_t peak() const { return end.peak > begin.current ? end.peak - begin.current : 0; }
+	// bytes still live at stop() that were not live at start()
+	int64_t retained() const { return static_cast<int64_t>(end.current) - static_cast<int64_t>(begin.current); }
+private:
+	alloc_detail::Totals begin{ 0, 0, 0, 0 };
+	alloc_detail::Totals end{ 0, 0, 0, 0 };
+};
+
+#ifdef TRACK_ALLOCATIONS
+void* operator new(size_t n) { return alloc_detail::allocate(n, alignof(std::max_align_t)); }
+void* operator new[](size_t n) { return alloc_detail::allocate(n, alignof(std::max_align_t)); }
+void* operator new(size_t n, std::align_val_t a) { return alloc_detail::allocate(n, static_cast<size_t>(a)); }
+void* operator new[](size_t n, std::align_val_t a) { return alloc_detail::allocate(n, static_cast<size_t>(a)); }
+void operator delete(void* p) noexcept { alloc_detail::release(p); }
+void operator delete[](void* p) noexcept { alloc_detail::release(p); }
+void operator delete(void* p, size_t) noexcept { alloc_detail::release(p); }
+void operator delete[](void* p, size_t) noexcept { alloc_detail::release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alloc_detail::release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alloc_detail::release(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alloc_detail::release(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alloc_detail::release(p); }
+#endif
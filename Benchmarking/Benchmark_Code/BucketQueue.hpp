@@ -0,0 +1,157 @@
+#pragma once
+/**
+	Description :
+	Bucket (Calendar) Queue for Integer Keys
+
+	Brown's calendar queue : key k belongs to day k / width, and day d
+	is kept in bucket d mod B, each bucket a small unsorted vector. The
+	queue remembers the current day; when today's keys run out it walks
+	forward day by day, and the first bucket holding keys of that day
+	hands them over to a short sorted list that removeMin() pops from.
+	The bucket count tracks the size (rebuilt when it doubles or halves)
+	and the width is set at each rebuild so a day holds about three keys,
+	so insert and removeMin are O(1) amortized for evenly spread keys; a
+	day full of duplicates is sorted once rather than rescanned. A walk
+	that finds a whole year empty jumps straight to the smallest key.
+
+	Unlike RadixHeap, inserting below the current minimum is allowed.
+	Same interface as HeapPriorityQueue.
+**/
+
+#include <vector> // std::vector
+#include <cstddef> // size_t
+#include <algorithm> // std::sort, std::upper_bound
+#include <functional> // std::greater
+#include <type_traits> // std::is_integral, std::make_unsigned, std::is_signed
+
+template <class T>
+class BucketQueue
+{
+	static_assert(std::is_integral<T>::value, "BucketQueue needs integer keys");
+	typedef typename std::make_unsigned<T>::type U;
+public:
+	BucketQueue() : count(0), logWidth(0), today(0), buckets(MIN_BUCKETS) {}
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	void insert(const T& e);
+	const T& min();
+	void removeMin();
+private:
+	static constexpr size_t MIN_BUCKETS = 16;
+	static constexpr U SIGN = std::is_signed<T>::value ? static_cast<U>(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+
+	static U toUnsigned(T x) { return static_cast<U>(x) ^ SIGN; }
+	U day(U x) const { return x >> logWidth; }
+	std::vector<T>& bucketOf(U d) { return buckets[static_cast<size_t>(d & (buckets.size() - 1))]; }
+	void locate(); // fill current with the next day that has keys
+	void putBack(); // return current to its bucket
+	void rebuild(size_t bucketCount);
+
+	int count;
+	int logWidth; // a day spans 2^logWidth keys
+	U today;
+	std::vector<T> current; // today's keys, largest first
+	std::vector<std::vector<T>> buckets; // a power of two of them
+};
+
+template <class T>
+void BucketQueue<T>::insert(const T& e)
+{
+	U x = toUnsigned(e);
+	if (count == 0 || day(x) < today) {
+		putBack();
+		today = day(x);
+	}
+	if (day(x) == today && !current.empty())
+		current.insert(std::upper_bound(current.begin(), current.end(), e, std::greater<T>()), e);
+	else
+		bucketOf(day(x)).push_back(e);
+	count++;
+	if (static_cast<size_t>(count) > 2 * buckets.size())
+		rebuild(2 * buckets.size());
+}
+
+template <class T>
+const T& BucketQueue<T>::min()
+{
+	locate();
+	return current.back();
+}
+
+template <class T>
+void BucketQueue<T>::removeMin()
+{
+	locate();
+	current.pop_back();
+	count--;
+	if (buckets.size() > MIN_BUCKETS && static_cast<size_t>(count) < buckets.size() / 2)
+		rebuild(buckets.size() / 2);
+}
+
+template <class T>
+void BucketQueue<T>::locate()
+{
+	if (!current.empty())
+		return;
+	for (size_t step = 0; step < buckets.size(); step++, today++) {
+		std::vector<T>& b = bucketOf(today);
+		for (size_t i = 0; i < b.size();) {
+			if (day(toUnsigned(b[i])) == today) {
+				current.push_back(b[i]);
+				b[i] = b.back(); // unsorted, fill the gap with the last key
+				b.pop_back();
+			}
+			else
+				i++;
+		}
+		if (!current.empty()) {
+			std::sort(current.begin(), current.end(), std::greater<T>());
+			return;
+		}
+	}
+	// a whole year without a key, jump to the smallest one
+	U m = 0;
+	bool any = false;
+	for (auto& b : buckets)
+		for (T e : b)
+			if (!any || toUnsigned(e) < m) {
+				m = toUnsigned(e);
+				any = true;
+			}
+	today = day(m);
+	locate();
+}
+
+template <class T>
+void BucketQueue<T>::putBack()
+{
+	std::vector<T>& b = bucketOf(today);
+	b.insert(b.end(), current.begin(), current.end());
+	current.clear();
+}
+
+template <class T>
+void BucketQueue<T>::rebuild(size_t bucketCount)
+{
+	putBack();
+	std::vector<T> all;
+	all.reserve(count);
+	U lo = 0, hi = 0;
+	for (auto& b : buckets)
+		for (T e : b) {
+			U x = toUnsigned(e);
+			if (all.empty() || x < lo) lo = x;
+			if (all.empty() || x > hi) hi = x;
+			all.push_back(e);
+		}
+	// about three keys per day across the current spread
+	U span = static_cast<U>((hi - lo) / (all.empty() ? 1 : all.size()));
+	span = span > static_cast<U>(~U(0)) / 3 ? static_cast<U>(~U(0)) : static_cast<U>(span * 3);
+	logWidth = 0;
+	while (logWidth + 1 < static_cast<int>(sizeof(T) * 8) && (U(1) << (logWidth + 1)) <= span)
+		logWidth++;
+	buckets.assign(bucketCount, std::vector<T>());
+	for (T e : all)
+		bucketOf(day(toUnsigned(e))).push_back(e);
+	today = day(lo);
+}
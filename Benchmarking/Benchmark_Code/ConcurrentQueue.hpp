@@ -0,0 +1,270 @@
+#pragma once
+/**
+	Description :
+	Lock-Free MPMC Queue (Michael-Scott) with Hazard Pointers
+
+	The LinkedList work queue without its mutex : insertBack() links a
+	node after the tail with a compare-and-swap, tryRemoveFront() swings
+	head to the node after the dummy with another, so any number of
+	producers and consumers make progress without blocking each other.
+	A lagging tail is helped forward by whichever thread sees it.
+
+	A dequeued node cannot be freed while another thread may still read
+	it. Before dereferencing head, tail or a next link a thread publishes
+	the pointer in one of its hazard pointers and re-reads the source to
+	be sure it is still current. A removed node is retired to a per
+	thread list, and once that list holds twice as many nodes as there
+	are hazard pointers in use (64 at least), every node no thread has
+	published is freed. A thread's record is claimed on its first
+	operation and given back, with its leftover retired nodes, when the
+	thread exits.
+
+	insertBack() allocates one node with new; FIFO order holds per
+	producer. empty() is exact only when no other thread is operating.
+**/
+
+#include <algorithm> // std::sort, std::binary_search
+#include <atomic> // std::atomic
+#include <mutex> // std::mutex, std::lock_guard
+#include <stdexcept> // std::runtime_error
+#include <vector> // std::vector
+
+namespace hazard_detail {
+
+	constexpr int MAX_THREADS = 256;
+	constexpr int SLOTS = 2; // hazard pointers per thread
+
+	struct alignas(64) Record {
+		std::atomic<bool> active{ false };
+		std::atomic<void*> hazard[SLOTS] = {};
+	};
+
+	struct Retired {
+		void* p;
+		void (*destroy)(void*);
+	};
+
+	// the records of every thread, shared by all queues
+	class Domain {
+	public:
+		static Domain& instance()
+		{
+			static Domain domain;
+			return domain;
+		}
+		~Domain() // every thread is gone
+		{
+			for (Retired& r : orphans)
+				r.destroy(r.p);
+		}
+
+		Record* acquire()
+		{
+			for (int i = 0; i < MAX_THREADS; i++) {
+				bool idle = false;
+				if (!records[i].active.load(std::memory_order_relaxed)
+					&& records[i].active.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+					int end = used.load(std::memory_order_relaxed);
+					while (end < i + 1 && !used.compare_exchange_weak(end, i + 1, std::memory_order_release))
+						;
+					return &records[i];
+				}
+			}
+			throw std::runtime_error("Error: more than 256 threads using hazard pointers");
+		}
+		int hazards() const { return SLOTS * used.load(std::memory_order_relaxed); }
+		void release(Record* r)
+		{
+			for (int s = 0; s < SLOTS; s++)
+				r->hazard[s].store(nullptr, std::memory_order_release);
+			r->active.store(false, std::memory_order_release);
+		}
+
+		// free every retired node no thread has published
+		void scan(std::vector<Retired>& retired)
+		{
+			std::vector<void*> published;
+			int end = used.load(std::memory_order_acquire);
+			for (int i = 0; i < end; i++)
+				for (int s = 0; s < SLOTS; s++) {
+					void* p = records[i].hazard[s].load(std::memory_order_seq_cst);
+					if (p)
+						published.push_back(p);
+				}
+			std::sort(published.begin(), published.end());
+			{
+				std::lock_guard<std::mutex> guard(orphanLock); // adopt what exited threads left
+				retired.insert(retired.end(), orphans.begin(), orphans.end());
+				orphans.clear();
+			}
+			size_t kept = 0;
+			for (Retired& r : retired) {
+				if (std::binary_search(published.begin(), published.end(), r.p))
+					retired[kept++] = r;
+				else
+					r.destroy(r.p);
+			}
+			retired.resize(kept);
+		}
+		void orphan(std::vector<Retired>& retired)
+		{
+			std::lock_guard<std::mutex> guard(orphanLock);
+			orphans.insert(orphans.end(), retired.begin(), retired.end());
+			retired.clear();
+		}
+	private:
+		Domain() : used(0) {}
+
+		Record records[MAX_THREADS];
+		std::atomic<int> used; // records[0, used) have been claimed at least once
+		std::mutex orphanLock;
+		std::vector<Retired> orphans;
+	};
+
+	// this thread's record and retired nodes
+	class ThreadState {
+	public:
+		ThreadState() : record(Domain::instance().acquire()) {}
+		~ThreadState()
+		{
+			Domain::instance().scan(retired);
+			Domain::instance().orphan(retired);
+			Domain::instance().release(record);
+		}
+		static ThreadState& local()
+		{
+			thread_local ThreadState state;
+			return state;
+		}
+
+		// publish src's pointer in slot s, valid once src still holds it
+		template <class T>
+		T* protect(int s, const std::atomic<T*>& src)
+		{
+			T* p = src.load(std::memory_order_relaxed);
+			for (;;) {
+				record->hazard[s].store(p, std::memory_order_seq_cst);
+				T* q = src.load(std::memory_order_seq_cst);
+				if (q == p)
+					return p;
+				p = q;
+			}
+		}
+		void clear()
+		{
+			for (int s = 0; s < SLOTS; s++)
+				record->hazard[s].store(nullptr, std::memory_order_release);
+		}
+		template <class T>
+		void retire(T* p)
+		{
+			retired.push_back(Retired{ p, [](void* q) { delete static_cast<T*>(q); } });
+			int threshold = 2 * Domain::instance().hazards();
+			if (retired.size() >= static_cast<size_t>(threshold < 64 ? 64 : threshold))
+				Domain::instance().scan(retired);
+		}
+	private:
+		Record* record;
+		std::vector<Retired> retired;
+	};
+}
+
+template <class NodeType>
+class ConcurrentQueue
+{
+public:
+	ConcurrentQueue();
+	~ConcurrentQueue(); // no thread may be operating
+	ConcurrentQueue(const ConcurrentQueue&) = delete;
+	ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+	void insertBack(const NodeType& item);
+	// pop the front into out, false if the queue was empty
+	bool tryRemoveFront(NodeType& out);
+	bool empty() const;
+private:
+	struct QueueNode {
+		QueueNode() : next(nullptr) {}
+		explicit QueueNode(const NodeType& e) : data(e), next(nullptr) {}
+		NodeType data = NodeType();
+		std::atomic<QueueNode*> next;
+	};
+
+	alignas(64) std::atomic<QueueNode*> head; // the dummy, its successor is the front
+	alignas(64) std::atomic<QueueNode*> tail; // the last node, or one behind it
+};
+
+template <class NodeType>
+ConcurrentQueue<NodeType>::ConcurrentQueue()
+{
+	QueueNode* dummy = new QueueNode;
+	head.store(dummy, std::memory_order_relaxed);
+	tail.store(dummy, std::memory_order_relaxed);
+}
+
+template <class NodeType>
+ConcurrentQueue<NodeType>::~ConcurrentQueue()
+{
+	QueueNode* p = head.load(std::memory_order_relaxed);
+	while (p) {
+		QueueNode* q = p->next.load(std::memory_order_relaxed);
+		delete p;
+		p = q;
+	}
+}
+
+template <class NodeType>
+void ConcurrentQueue<NodeType>::insertBack(const NodeType& item)
+{
+	hazard_detail::ThreadState& state = hazard_detail::ThreadState::local();
+	QueueNode* node = new QueueNode(item);
+	for (;;) {
+		QueueNode* t = state.protect(0, tail);
+		QueueNode* next = t->next.load(std::memory_order_acquire);
+		if (next != nullptr) { // tail is lagging, help it along
+			tail.compare_exchange_strong(t, next, std::memory_order_release, std::memory_order_relaxed);
+			continue;
+		}
+		if (t->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed)) {
+			tail.compare_exchange_strong(t, node, std::memory_order_release, std::memory_order_relaxed);
+			break;
+		}
+	}
+	state.clear();
+}
+
+template <class NodeType>
+bool ConcurrentQueue<NodeType>::tryRemoveFront(NodeType& out)
+{
+	hazard_detail::ThreadState& state = hazard_detail::ThreadState::local();
+	for (;;) {
+		QueueNode* h = state.protect(0, head);
+		QueueNode* next = state.protect(1, h->next);
+		if (h != head.load(std::memory_order_acquire))
+			continue; // h was removed, next may be stale
+		if (next == nullptr) {
+			state.clear();
+			return false;
+		}
+		QueueNode* t = tail.load(std::memory_order_acquire);
+		if (h == t) { // tail still on the dummy, move it first
+			tail.compare_exchange_strong(t, next, std::memory_order_release, std::memory_order_relaxed);
+			continue;
+		}
+		if (head.compare_exchange_strong(h, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+			out = next->data; // next is the new dummy, still protected by slot 1
+			state.clear();
+			state.retire(h);
+			return true;
+		}
+	}
+}
+
+template <class NodeType>
+bool ConcurrentQueue<NodeType>::empty() const
+{
+	hazard_detail::ThreadState& state = hazard_detail::ThreadState::local();
+	bool none = state.protect(0, head)->next.load(std::memory_order_acquire) == nullptr;
+	state.clear();
+	return none;
+}
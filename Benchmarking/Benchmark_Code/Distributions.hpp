@@ -0,0 +1,322 @@
+#pragma once
+/**
+	Description :
+	Seeded, Reproducible Input Distributions for the Benchmarks
+
+	Every element is a pure function of (seed, index), so a stream can be
+	generated by any number of threads, or block by block straight to a
+	file, and still come out identical. The nearly sorted swaps too : a
+	seeded permutation of the positions pairs up ranks 2m and 2m + 1 for
+	m < k, so any position can tell whether it is swapped, and with which.
+
+	Distributions :
+		uniform			full 32-bit int range
+		sorted			non-decreasing over the int range
+		reverse			non-increasing over the int range
+		nearly-sorted	sorted, then k disjoint random pairs swapped
+		few-unique		a handful of distinct keys
+		organ-pipe		ascending first half, descending second half
+		sawtooth		several ascending ramps
+		zipf			Zipf(s) ranks over a key space (rejection-inversion)
+		dup-heavy		most elements drawn from a few hot keys
+**/
+
+#include <cstdint> // uint64_t, int32_t
+#include <cstdio> // std::FILE, std::fopen
+#include <cmath> // std::log, std::exp
+#include <climits> // INT_MIN
+#include <string> // std::string
+#include <vector> // std::vector
+#include <thread> // std::thread
+#include <algorithm> // std::min
+
+enum Distribution {
+	DIST_UNIFORM,
+	DIST_SORTED,
+	DIST_REVERSE,
+	DIST_NEARLY_SORTED,
+	DIST_FEW_UNIQUE,
+	DIST_ORGAN_PIPE,
+	DIST_SAWTOOTH,
+	DIST_ZIPF,
+	DIST_DUPLICATE_HEAVY,
+	NUM_DISTRIBUTIONS
+};
+
+struct DistributionParams {
+	uint64_t seed = 1;
+	size_t swaps = 0;			// nearly-sorted swaps, 0 picks n / 100
+	int uniqueKeys = 16;		// few-unique key count
+	int teeth = 8;				// sawtooth ramps
+	double zipfExponent = 1.0;	// zipf skew s
+	int zipfKeys = 1 << 20;		// zipf key space
+	int hotKeys = 8;			// dup-heavy hot keys
+	double hotFraction = 0.9;	// dup-heavy share of hot keys
+	unsigned threads = 0;		// generator threads, 0 uses every core
+};
+
+const char* distributionName(Distribution d);
+// parse a name from distributionName(), returns NUM_DISTRIBUTIONS if unknown
+Distribution distributionFromName(const std::string& name);
+
+// value of element i of an n element stream
+int distributionValue(Distribution d, uint64_t i, uint64_t n, const DistributionParams& p);
+// fill out[0..n) in parallel
+void generateDistribution(Distribution d, int* out, uint64_t n, const DistributionParams& p);
+void generateDistribution(Distribution d, std::vector<int>& out, size_t n, const DistributionParams& p);
+// stream n elements to a binary file of native ints, blockElems at a time,
+// for inputs larger than RAM; returns false on I/O error
+bool writeDistribution(const std::string& path, Distribution d, uint64_t n,
+	const DistributionParams& p, size_t blockElems = size_t(1) << 24);
+
+
+namespace dist_detail {
+
+	// splitmix64 finaliser, used as a counter-based generator
+	inline uint64_t mix(uint64_t x)
+	{
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	inline uint64_t hash(uint64_t seed, uint64_t i) { return mix(seed ^ mix(i)); }
+
+	// uniform double in [0, 1) from the top 53 bits
+	inline double unit(uint64_t x) { return (x >> 11) * (1.0 / 9007199254740992.0); }
+
+	// x in [0, 1] to a non-decreasing int over the full range
+	inline int scale(double x)
+	{
+		double v = static_cast<double>(INT_MIN) + x * 4294967295.0;
+		return static_cast<int>(static_cast<int64_t>(v));
+	}
+
+	inline int ramp(uint64_t i, uint64_t n) { return n > 1 ? scale(static_cast<double>(i) / (n - 1)) : 0; }
+
+	inline uint64_t swapCount(uint64_t n, const DistributionParams& p)
+	{
+		uint64_t k = p.swaps ? p.swaps : (n / 100 ? n / 100 : 1);
+		return std::min<uint64_t>(k, n / 2); // disjoint pairs
+	}
+
+	// seeded permutation of [0, n) : a 4 round Feistel network over the
+	// smallest 4^half >= n, cycle-walked until it lands inside [0, n)
+	class PositionPermutation {
+	public:
+		PositionPermutation(uint64_t n, uint64_t seed) : n(n), half(1)
+		{
+			while (half < 31 && (uint64_t(1) << (2 * half)) < n)
+				half++;
+			mask = (uint64_t(1) << half) - 1;
+			for (int round = 0; round < 4; round++)
+				keys[round] = hash(seed, round);
+		}
+		uint64_t forward(uint64_t x) const
+		{
+			do {
+				uint64_t l = x >> half, r = x & mask;
+				for (int round = 0; round < 4; round++) {
+					uint64_t t = l ^ (mix(r ^ keys[round]) & mask);
+					l = r;
+					r = t;
+				}
+				x = l << half | r;
+			} while (x >= n);
+			return x;
+		}
+		uint64_t inverse(uint64_t x) const
+		{
+			do {
+				uint64_t l = x >> half, r = x & mask;
+				for (int round = 4; round-- > 0;) {
+					uint64_t t = r ^ (mix(l ^ keys[round]) & mask);
+					r = l;
+					l = t;
+				}
+				x = l << half | r;
+			} while (x >= n);
+			return x;
+		}
+	private:
+		uint64_t n;
+		int half; // bits per Feistel half
+		uint64_t mask;
+		uint64_t keys[4]; // round keys
+	};
+
+	// the position whose sorted value ends up at i
+	inline uint64_t swapSource(uint64_t i, uint64_t k, const PositionPermutation& perm)
+	{
+		uint64_t rank = perm.forward(i);
+		return rank < 2 * k ? perm.inverse(rank ^ 1) : i;
+	}
+
+	// Hormann & Derflinger rejection-inversion Zipf sampler over ranks 1..N
+	class ZipfSampler {
+	public:
+		ZipfSampler(int keys, double exponent) : N(keys), s(exponent)
+		{
+			hX1 = hIntegral(1.5) - 1.0;
+			hN = hIntegral(N + 0.5);
+			sq = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+		}
+		// draws uniforms from state until a rank is accepted
+		int sample(uint64_t& state) const
+		{
+			for (;;) {
+				state = mix(state);
+				double u = hN + unit(state) * (hX1 - hN);
+				double x = hIntegralInverse(u);
+				double k = std::floor(x + 0.5);
+				if (k < 1) k = 1;
+				else if (k > N) k = N;
+				if (k - x <= sq || u >= hIntegral(k + 0.5) - h(k))
+					return static_cast<int>(k);
+			}
+		}
+	private:
+		static double helper1(double x) { return std::fabs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x)); }
+		static double helper2(double x) { return std::fabs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x)); }
+		double h(double x) const { return std::exp(-s * std::log(x)); }
+		double hIntegral(double x) const { double lx = std::log(x); return helper2((1.0 - s) * lx) * lx; }
+		double hIntegralInverse(double x) const
+		{
+			double t = x * (1.0 - s);
+			if (t < -1.0) t = -1.0;
+			return std::exp(helper1(t) * x);
+		}
+
+		int N;
+		double s, hX1, hN, sq;
+	};
+
+	inline int value(Distribution d, uint64_t i, uint64_t n, const DistributionParams& p,
+		const ZipfSampler& zipf, const PositionPermutation& perm)
+	{
+		uint64_t r = hash(p.seed, i);
+		switch (d) {
+		case DIST_UNIFORM:
+			return static_cast<int32_t>(static_cast<uint32_t>(r >> 32));
+		case DIST_SORTED:
+			return ramp(i, n);
+		case DIST_NEARLY_SORTED:
+			return ramp(swapSource(i, swapCount(n, p), perm), n);
+		case DIST_REVERSE:
+			return ramp(n - 1 - i, n);
+		case DIST_FEW_UNIQUE:
+			return ramp(r % p.uniqueKeys, p.uniqueKeys);
+		case DIST_ORGAN_PIPE: {
+			uint64_t half = (n + 1) / 2;
+			return i < half ? ramp(i, half) : ramp(n - 1 - i, half);
+		}
+		case DIST_SAWTOOTH: {
+			uint64_t tooth = (n + p.teeth - 1) / p.teeth;
+			return ramp(i % tooth, tooth);
+		}
+		case DIST_ZIPF: {
+			// scatter ranks so the hottest key is not also the smallest
+			uint64_t state = r;
+			int rank = zipf.sample(state);
+			return static_cast<int32_t>(static_cast<uint32_t>(hash(p.seed ^ 0x5A1Full, rank) >> 32));
+		}
+		case DIST_DUPLICATE_HEAVY:
+			if (unit(r) < p.hotFraction)
+				return static_cast<int32_t>(static_cast<uint32_t>(hash(p.seed ^ 0xD0Full, (r >> 8) % p.hotKeys) >> 32));
+			return static_cast<int32_t>(static_cast<uint32_t>(mix(r) >> 32));
+		default:
+			return 0;
+		}
+	}
+
+	inline unsigned threadCount(const DistributionParams& p)
+	{
+		unsigned t = p.threads ? p.threads : std::thread::hardware_concurrency();
+		return t ? t : 1;
+	}
+
+	// fill out[0..count) with elements begin..begin+count of the stream
+	inline void fill(Distribution d, int* out, uint64_t begin, uint64_t count, uint64_t n, const DistributionParams& p)
+	{
+		ZipfSampler zipf(p.zipfKeys, p.zipfExponent);
+		PositionPermutation perm(n, p.seed ^ 0x5EAull);
+		unsigned t = threadCount(p);
+		if (count < 65536)
+			t = 1;
+		std::vector<std::thread> workers;
+		uint64_t chunk = (count + t - 1) / t;
+		for (unsigned w = 0; w < t; w++) {
+			uint64_t lo = w * chunk, hi = std::min(count, lo + chunk);
+			if (lo >= hi)
+				break;
+			workers.emplace_back([=, &zipf, &perm]() {
+				for (uint64_t j = lo; j < hi; j++)
+					out[j] = value(d, begin + j, n, p, zipf, perm);
+			});
+		}
+		for (auto& w : workers)
+			w.join();
+	}
+
+}
+
+inline const char* distributionName(Distribution d)
+{
+	switch (d) {
+	case DIST_UNIFORM: return "uniform";
+	case DIST_SORTED: return "sorted";
+	case DIST_REVERSE: return "reverse";
+	case DIST_NEARLY_SORTED: return "nearly-sorted";
+	case DIST_FEW_UNIQUE: return "few-unique";
+	case DIST_ORGAN_PIPE: return "organ-pipe";
+	case DIST_SAWTOOTH: return "sawtooth";
+	case DIST_ZIPF: return "zipf";
+	case DIST_DUPLICATE_HEAVY: return "dup-heavy";
+	default: return "?";
+	}
+}
+
+inline Distribution distributionFromName(const std::string& name)
+{
+	for (int d = 0; d < NUM_DISTRIBUTIONS; d++)
+		if (name == distributionName(static_cast<Distribution>(d)))
+			return static_cast<Distribution>(d);
+	return NUM_DISTRIBUTIONS;
+}
+
+inline int distributionValue(Distribution d, uint64_t i, uint64_t n, const DistributionParams& p)
+{
+	dist_detail::ZipfSampler zipf(p.zipfKeys, p.zipfExponent);
+	dist_detail::PositionPermutation perm(n, p.seed ^ 0x5EAull);
+	return dist_detail::value(d, i, n, p, zipf, perm);
+}
+
+inline void generateDistribution(Distribution d, int* out, uint64_t n, const DistributionParams& p)
+{
+	if (n == 0)
+		return;
+	dist_detail::fill(d, out, 0, n, n, p);
+}
+
+inline void generateDistribution(Distribution d, std::vector<int>& out, size_t n, const DistributionParams& p)
+{
+	out.resize(n);
+	generateDistribution(d, out.data(), n, p);
+}
+
+inline bool writeDistribution(const std::string& path, Distribution d, uint64_t n,
+	const DistributionParams& p, size_t blockElems)
+{
+	std::FILE* f = std::fopen(path.c_str(), "wb");
+	if (!f)
+		return false;
+	std::vector<int> block(static_cast<size_t>(std::min<uint64_t>(blockElems, n)));
+	bool ok = true;
+	for (uint64_t begin = 0; ok && begin < n; begin += block.size()) {
+		size_t count = static_cast<size_t>(std::min<uint64_t>(block.size(), n - begin));
+		dist_detail::fill(d, block.data(), begin, count, n, p);
+		ok = std::fwrite(block.data(), sizeof(int), count, f) == count;
+	}
+	return std::fclose(f) == 0 && ok;
+}
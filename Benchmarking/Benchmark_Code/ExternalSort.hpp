@@ -0,0 +1,473 @@
+#pragma once
+/**
+	Description :
+	External Memory Merge Sort for Files of Native ints
+
+	Phase 1 (runs) : read the input one memory budget at a time, split the
+	chunk into one slice per thread, std::sort the slices in parallel and
+	write each slice as a sorted run with large sequential writes.
+
+	Phase 2 (merge) : k-way merge of the runs through a HeapPriorityQueue
+	of run heads. Every run is read through two buffers, the next block is
+	read asynchronously while the current one is consumed, and the output
+	is written the same way. A merge reads at most fanIn runs at once,
+	bounded by the open file limit and by two 4 KiB blocks per run within
+	the memory budget; with more runs than that, earlier passes merge
+	them fanIn at a time into longer runs until one pass is left.
+
+	On Linux, directIO opens the files with O_DIRECT (falling back to
+	buffered I/O where the file system refuses it, e.g. tmpfs); buffers
+	and block sizes are kept 4 KiB aligned for that.
+
+	Errors (unreadable input, full disk, ...) throw std::runtime_error.
+	The runs are removed either way, and so is a partly written output.
+**/
+
+#include <cstdint> // uint64_t
+#include <cstdio> // std::remove
+#include <cstdlib> // std::free
+#include <string> // std::string
+#include <vector> // std::vector
+#include <thread> // std::thread
+#include <future> // std::async, std::future
+#include <chrono> // steady_clock
+#include <algorithm> // std::sort, std::min
+#include <stdexcept> // std::runtime_error
+
+#ifdef __linux__
+#include <fcntl.h> // open(), O_DIRECT
+#include <unistd.h> // read(), write(), ftruncate()
+#include <cerrno> // errno
+#else
+#include <cstdio> // std::fopen
+#endif
+
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc
+#else
+#include <sys/resource.h> // getrlimit()
+#endif
+
+#include "HeapPriorityQueue.hpp"
+
+struct ExternalSortConfig {
+	size_t memoryBudget = size_t(256) << 20;	// bytes for a run, also split across merge buffers
+	std::string tempDir = ".";					// where runs are written
+	unsigned threads = 0;						// run sort threads, 0 uses every core
+	bool directIO = false;						// O_DIRECT on Linux
+	size_t ioBlock = size_t(8) << 20;			// bytes per sequential read or write
+};
+
+struct ExternalSortStats {
+	uint64_t elements = 0;
+	size_t runs = 0;
+	double runSeconds = 0;		// read, sort and write runs
+	double mergeSeconds = 0;	// read runs, merge and write output
+	size_t passes = 0;			// merge passes, more than 1 when the runs exceed the fan-in
+	double runMBps() const { return runSeconds > 0 ? elements * sizeof(int) / runSeconds / 1e6 : 0; }
+	double mergeMBps() const { return mergeSeconds > 0 ? elements * sizeof(int) / mergeSeconds / 1e6 : 0; }
+	double totalMBps() const { return runSeconds + mergeSeconds > 0 ? elements * sizeof(int) / (runSeconds + mergeSeconds) / 1e6 : 0; }
+};
+
+// sort the ints in inPath into outPath
+ExternalSortStats externalSort(const std::string& inPath, const std::string& outPath,
+	const ExternalSortConfig& config = ExternalSortConfig());
+
+
+namespace ext_detail {
+
+	const size_t ALIGN = 4096; // O_DIRECT buffer, offset and length alignment
+	const size_t FD_RESERVE = 32; // descriptors left to stdio, perf counters and the rest of the process
+
+	inline size_t alignDown(size_t x) { return x / ALIGN * ALIGN; }
+	inline size_t alignUp(size_t x) { return (x + ALIGN - 1) / ALIGN * ALIGN; }
+
+	// page aligned heap buffer
+	class AlignedBuffer {
+	public:
+		AlignedBuffer() {}
+		explicit AlignedBuffer(size_t bytes) { allocate(bytes); }
+		~AlignedBuffer() { release(); }
+		AlignedBuffer(const AlignedBuffer&) = delete;
+		AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+		void allocate(size_t bytes)
+		{
+			release();
+			size = alignUp(bytes);
+#ifdef _WIN32
+			data = static_cast<char*>(_aligned_malloc(size, ALIGN));
+#else
+			void* p = nullptr;
+			data = posix_memalign(&p, ALIGN, size) == 0 ? static_cast<char*>(p) : nullptr;
+#endif
+			if (!data)
+				throw std::runtime_error("Error: out of memory for I/O buffer");
+		}
+		void release()
+		{
+#ifdef _WIN32
+			_aligned_free(data);
+#else
+			std::free(data);
+#endif
+			data = nullptr;
+			size = 0;
+		}
+		char* data = nullptr;
+		size_t size = 0;
+	};
+
+	// sequential binary file, O_DIRECT where requested and supported
+	class RawFile {
+	public:
+		RawFile() {}
+		~RawFile() { close(); }
+		RawFile(const RawFile&) = delete;
+		RawFile& operator=(const RawFile&) = delete;
+
+		void open(const std::string& path, bool write, bool direct)
+		{
+			name = path;
+#ifdef __linux__
+			int flags = write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+			fd = direct ? ::open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+			isDirect = fd >= 0;
+			if (fd < 0)
+				fd = ::open(path.c_str(), flags, 0644);
+			if (fd < 0)
+#else
+			(void)direct;
+			f = std::fopen(path.c_str(), write ? "wb" : "rb");
+			if (!f)
+#endif
+				throw std::runtime_error("Error: cannot open " + path);
+		}
+
+		// read up to bytes, returns 0 at end of file
+		size_t read(char* buf, size_t bytes)
+		{
+			size_t got = 0;
+#ifdef __linux__
+			while (got < bytes) {
+				ssize_t r = ::read(fd, buf + got, bytes - got);
+				if (r < 0 && errno == EINTR)
+					continue;
+				if (r < 0)
+					throw std::runtime_error("Error: read failed on " + name);
+				if (r == 0)
+					break;
+				got += static_cast<size_t>(r);
+			}
+#else
+			got = std::fread(buf, 1, bytes, f);
+			if (got < bytes && std::ferror(f))
+				throw std::runtime_error("Error: read failed on " + name);
+#endif
+			return got;
+		}
+
+		// buf must be an AlignedBuffer with room to pad bytes up to ALIGN
+		void write(const char* buf, size_t bytes)
+		{
+#ifdef __linux__
+			size_t len = isDirect ? alignUp(bytes) : bytes;
+			size_t done = 0;
+			while (done < len) {
+				ssize_t w = ::write(fd, buf + done, len - done);
+				if (w < 0 && errno == EINTR)
+					continue;
+				if (w <= 0)
+					throw std::runtime_error("Error: write failed on " + name);
+				done += static_cast<size_t>(w);
+			}
+			written += bytes;
+			if (len != bytes) // padded tail, cut it off again
+				if (ftruncate(fd, static_cast<off_t>(written)) != 0)
+					throw std::runtime_error("Error: truncate failed on " + name);
+#else
+			if (std::fwrite(buf, 1, bytes, f) != bytes)
+				throw std::runtime_error("Error: write failed on " + name);
+#endif
+		}
+
+		void close()
+		{
+#ifdef __linux__
+			if (fd >= 0)
+				::close(fd);
+			fd = -1;
+#else
+			if (f)
+				std::fclose(f);
+			f = nullptr;
+#endif
+		}
+	private:
+		std::string name;
+#ifdef __linux__
+		int fd = -1;
+		bool isDirect = false;
+		uint64_t written = 0;
+#else
+		std::FILE* f = nullptr;
+#endif
+	};
+
+	// sorted run read through two buffers, one of them always in flight
+	class RunReader {
+	public:
+		void open(const std::string& path, size_t blockBytes, bool direct)
+		{
+			file.open(path, false, direct);
+			front.allocate(blockBytes);
+			back.allocate(blockBytes);
+			pending = std::async(std::launch::async, &RawFile::read, &file, back.data, back.size);
+			refill();
+		}
+		~RunReader()
+		{
+			if (pending.valid())
+				pending.wait();
+		}
+		bool empty() const { return curr == end; }
+		int head() const { return *curr; }
+		// advance, refilling from the buffer read in the background
+		void pop()
+		{
+			if (++curr == end)
+				refill();
+		}
+	private:
+		void refill()
+		{
+			size_t got = pending.valid() ? pending.get() : 0;
+			std::swap(front.data, back.data);
+			curr = reinterpret_cast<const int*>(front.data);
+			end = curr + got / sizeof(int);
+			if (got == back.size) // maybe more, start the next read
+				pending = std::async(std::launch::async, &RawFile::read, &file, back.data, back.size);
+		}
+
+		RawFile file;
+		AlignedBuffer front, back;
+		std::future<size_t> pending;
+		const int* curr = nullptr;
+		const int* end = nullptr;
+	};
+
+	// output written through two buffers, one of them always in flight
+	class RunWriter {
+	public:
+		void open(const std::string& path, size_t blockBytes, bool direct)
+		{
+			file.open(path, true, direct);
+			front.allocate(blockBytes);
+			back.allocate(blockBytes);
+			curr = reinterpret_cast<int*>(front.data);
+			end = curr + front.size / sizeof(int);
+		}
+		void push(int x)
+		{
+			*curr++ = x;
+			if (curr == end)
+				flush();
+		}
+		void close()
+		{
+			flush();
+			if (pending.valid())
+				pending.get();
+			file.close();
+		}
+	private:
+		void flush()
+		{
+			size_t bytes = (curr - reinterpret_cast<int*>(front.data)) * sizeof(int);
+			if (pending.valid())
+				pending.get(); // back buffer is free again
+			if (bytes > 0)
+				pending = std::async(std::launch::async, &RawFile::write, &file, front.data, bytes);
+			std::swap(front.data, back.data);
+			curr = reinterpret_cast<int*>(front.data);
+			end = curr + front.size / sizeof(int);
+		}
+
+		RawFile file;
+		AlignedBuffer front, back;
+		std::future<void> pending;
+		int* curr = nullptr;
+		int* end = nullptr;
+	};
+
+	// removes the files it holds when destroyed, keep() lets them stay
+	class FileGuard {
+	public:
+		FileGuard() {}
+		~FileGuard()
+		{
+			for (auto& name : names)
+				std::remove(name.c_str());
+		}
+		FileGuard(const FileGuard&) = delete;
+		FileGuard& operator=(const FileGuard&) = delete;
+
+		void add(const std::string& name) { names.push_back(name); }
+		void keep() { names.clear(); }
+	private:
+		std::vector<std::string> names;
+	};
+
+	struct RunHead {
+		int key;
+		int run;
+	};
+
+	class RunHeadCompare {
+	public:
+		bool operator () (const RunHead& x, const RunHead& y) const { return x.key < y.key; }
+	};
+
+	inline double seconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// runs one merge may open at once, one descriptor and two blocks each, 2 at least
+	inline size_t mergeFanIn(size_t memoryBudget)
+	{
+#ifdef _WIN32
+		size_t files = static_cast<size_t>(_getmaxstdio());
+#else
+		rlimit limit;
+		size_t files = getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+			? static_cast<size_t>(limit.rlim_cur) : size_t(1) << 20;
+#endif
+		files = files > FD_RESERVE + 1 ? files - FD_RESERVE - 1 : 0; // and one for the output
+		size_t blocks = memoryBudget / ALIGN;
+		size_t memory = blocks > 2 ? (blocks - 2) / 2 : 0; // and two for the output
+		return std::max(std::min(files, memory), size_t(2));
+	}
+
+	// k-way merge of the runs into outPath, which is removed again if the merge fails
+	inline void mergeRuns(const std::vector<std::string>& runs, const std::string& outPath,
+		const ExternalSortConfig& config)
+	{
+		// two buffers per run plus two for the output
+		size_t blockBytes = alignDown(config.memoryBudget / (2 * runs.size() + 2));
+		blockBytes = std::min(std::max(blockBytes, ALIGN), alignUp(config.ioBlock));
+		std::vector<RunReader> readers(runs.size());
+		HeapPriorityQueue<RunHead, RunHeadCompare> heads;
+		for (size_t r = 0; r < runs.size(); r++) {
+			readers[r].open(runs[r], blockBytes, config.directIO);
+			if (!readers[r].empty())
+				heads.insert(RunHead{ readers[r].head(), static_cast<int>(r) });
+		}
+		FileGuard partial; // before out, which finishes its last write before partial removes the file
+		RunWriter out;
+		out.open(outPath, blockBytes, config.directIO);
+		partial.add(outPath);
+		while (!heads.empty()) {
+			RunHead h = heads.min();
+			heads.removeMin();
+			out.push(h.key);
+			RunReader& reader = readers[h.run];
+			reader.pop();
+			if (!reader.empty())
+				heads.insert(RunHead{ reader.head(), h.run });
+		}
+		out.close();
+		partial.keep();
+	}
+}
+
+inline ExternalSortStats externalSort(const std::string& inPath, const std::string& outPath,
+	const ExternalSortConfig& config)
+{
+	using namespace ext_detail;
+	ExternalSortStats stats;
+	unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+	std::string prefix = config.tempDir + "/extsort-"
+		+ std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-";
+	std::vector<std::string> runs;
+	FileGuard temp; // every run, declared first so the files are closed before it removes them
+
+	/*
+		Phase 1 : RAM sized chunks, one sorted run per thread slice
+	*/
+	auto start = std::chrono::steady_clock::now();
+	{
+		size_t chunkBytes = std::max(alignDown(config.memoryBudget), ALIGN * threads);
+		AlignedBuffer chunk(chunkBytes);
+		RawFile in;
+		in.open(inPath, false, config.directIO);
+		for (;;) {
+			size_t got = in.read(chunk.data, chunk.size);
+			size_t n = got / sizeof(int);
+			if (n == 0)
+				break;
+			int* data = reinterpret_cast<int*>(chunk.data);
+			// slices start on ALIGN boundaries so they can be written with O_DIRECT
+			size_t perSlice = alignUp((n * sizeof(int) + threads - 1) / threads) / sizeof(int);
+			size_t block = alignUp(config.ioBlock);
+			std::vector<std::string> names;
+			for (size_t lo = 0; lo < n; lo += perSlice) {
+				names.push_back(prefix + std::to_string(runs.size() + names.size()) + ".run");
+				temp.add(names.back());
+			}
+			// a future holds its slice's exception, and waits for the slice if destroyed early
+			std::vector<std::future<void>> workers;
+			for (size_t lo = 0; lo < n; lo += perSlice) {
+				size_t hi = std::min(n, lo + perSlice);
+				const std::string& name = names[lo / perSlice];
+				workers.push_back(std::async(std::launch::async, [=, &name, &config]() {
+					std::sort(data + lo, data + hi);
+					const char* bytes = reinterpret_cast<const char*>(data);
+					RawFile run;
+					run.open(name, true, config.directIO);
+					for (size_t b = lo * sizeof(int); b < hi * sizeof(int); b += block)
+						run.write(bytes + b, std::min(block, hi * sizeof(int) - b));
+				}));
+			}
+			for (auto& w : workers) // every slice is done with chunk before one rethrows
+				w.wait();
+			for (auto& w : workers)
+				w.get();
+			runs.insert(runs.end(), names.begin(), names.end());
+			stats.elements += n;
+			if (got < chunk.size)
+				break;
+		}
+	}
+	stats.runs = runs.size();
+	stats.runSeconds = seconds(start);
+
+	/*
+		Phase 2 : k-way merges through a heap of run heads, fanIn runs at a
+		time until the last pass can write the output
+	*/
+	start = std::chrono::steady_clock::now();
+	size_t fanIn = mergeFanIn(config.memoryBudget);
+	for (; runs.size() > fanIn; stats.passes++) {
+		std::vector<std::string> merged;
+		for (size_t lo = 0; lo < runs.size(); lo += fanIn) {
+			std::vector<std::string> group(runs.begin() + lo, runs.begin() + std::min(runs.size(), lo + fanIn));
+			if (group.size() == 1) { // left over, goes on to the next pass as is
+				merged.push_back(group.front());
+				continue;
+			}
+			merged.push_back(prefix + "pass" + std::to_string(stats.passes) + "-" + std::to_string(merged.size()) + ".run");
+			mergeRuns(group, merged.back(), config);
+			temp.add(merged.back());
+			for (auto& name : group) // free the disk space now, temp removing them again is harmless
+				std::remove(name.c_str());
+		}
+		runs.swap(merged);
+	}
+	mergeRuns(runs, outPath, config);
+	stats.passes++;
+	stats.mergeSeconds = seconds(start);
+	return stats;
+}
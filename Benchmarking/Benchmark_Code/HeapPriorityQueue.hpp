@@ -1,80 +1,178 @@
 // Adapted from Goodrich
 #pragma once
+#include <utility> // std::move
 #include "VectorCompleteTree.hpp"
 
-template <class NodeType, class C>
+// D is the arity of the heap, 4 or 8 keep the children of a node in one cache line.
+// Sifting moves a hole instead of swapping, the sifted element is written once.
+template <class NodeType, class C, int D = 2>
 class HeapPriorityQueue
 {
 public:
+	HeapPriorityQueue() {}
+	template <class InputIt>
+	HeapPriorityQueue(InputIt first, InputIt last); // Floyd heapify, O(n)
 	int size() const; // number of elements
 	bool empty() const; 
 	void insert(const NodeType& e);
+	void insert(NodeType&& e);
+	template <class InputIt>
+	void pushRange(InputIt first, InputIt last);
 	const NodeType& min();	
 	void removeMin(); 
+	// move the k smallest to out in ascending order
+	template <class OutputIt>
+	OutputIt popN(int k, OutputIt out);
+	// move everything to out in ascending order and leave the heap empty
+	template <class OutputIt>
+	OutputIt drainSorted(OutputIt out) { return popN(size(), out); }
 	void display();
 private:
-	VectorCompleteTree<NodeType> T;	// vector implementation of heap
+	VectorCompleteTree<NodeType, D> T;	// vector implementation of heap
 	C isLess; // less than comparator
 
-	typedef typename VectorCompleteTree<NodeType>::Position Position; // create alias for Position member of VectorCompleteTree													  
+	typedef typename VectorCompleteTree<NodeType, D>::Position Position; // create alias for Position member of VectorCompleteTree													  
+
+	void upHeap(Position v, NodeType e); // e goes into the hole at v
+	void downHeap(Position u, NodeType e);
+	void heapify();
 };
 
-template <class NodeType, class C>
-int HeapPriorityQueue<NodeType, C>::size() const
+template <class NodeType, class C, int D>
+template <class InputIt>
+HeapPriorityQueue<NodeType, C, D>::HeapPriorityQueue(InputIt first, InputIt last)
+{
+	pushRange(first, last);
+}
+
+template <class NodeType, class C, int D>
+int HeapPriorityQueue<NodeType, C, D>::size() const
 {
 	return T.size();
 }
 
-template <class NodeType, class C>
-bool HeapPriorityQueue<NodeType, C>::empty() const
+template <class NodeType, class C, int D>
+bool HeapPriorityQueue<NodeType, C, D>::empty() const
 {
 	return size() == 0;
 }
 
-template <class NodeType, class C>
-const NodeType& HeapPriorityQueue<NodeType, C>::min()
+template <class NodeType, class C, int D>
+const NodeType& HeapPriorityQueue<NodeType, C, D>::min()
 {
 	return *(T.root());
 }
 
-template <class NodeType, class C>
-void HeapPriorityQueue<NodeType, C>::insert(const NodeType& e)
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::insert(const NodeType& e)
+{
+	insert(NodeType(e));
+}
+
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::insert(NodeType&& e)
+{
+	T.addLast(std::move(e)); // open a hole at the end of the heap
+	Position v = T.last();
+	upHeap(v, std::move(*v));
+}
+
+template <class NodeType, class C, int D>
+template <class InputIt>
+void HeapPriorityQueue<NodeType, C, D>::pushRange(InputIt first, InputIt last)
+{
+	int before = size();
+	for (; first != last; ++first)
+		T.addLast(*first);
+	int added = size() - before;
+	// rebuild in O(n) unless the added elements are few enough that
+	// up-heaps, O(added log n), are cheaper
+	int lg = 1;
+	while ((size() >> lg) > 0)
+		lg++;
+	if (static_cast<long long>(added) * lg >= size()) {
+		heapify();
+		return;
+	}
+	Position v = T.last() - (added - 1);
+	for (int i = 0; i < added; i++, ++v)
+		upHeap(v, std::move(*v));
+}
+
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::removeMin()
+{
+	NodeType e = std::move(*T.last()); // last element refills the root's hole
+	T.removeLast();
+	if (!empty())
+		downHeap(T.root(), std::move(e));
+}
+
+// Bottom-up pops : the root's hole sinks to a leaf along the smallest
+// children, one comparison per level, then the last element rises from
+// there. It rarely rises far, so this beats the two comparisons per
+// level of a plain down-heap.
+template <class NodeType, class C, int D>
+template <class OutputIt>
+OutputIt HeapPriorityQueue<NodeType, C, D>::popN(int k, OutputIt out)
+{
+	for (; k > 0 && !empty(); k--) {
+		*out = std::move(*T.root());
+		++out;
+		NodeType e = std::move(*T.last());
+		T.removeLast();
+		if (empty())
+			break;
+		Position hole = T.root();
+		while (T.hasLeft(hole)) {
+			Position v = T.minChild(hole, isLess);
+			*hole = std::move(*v);
+			hole = v;
+		}
+		upHeap(hole, std::move(e));
+	}
+	return out;
+}
+
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::display()
+{
+	T.display();
+}
+
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::upHeap(Position v, NodeType e)
 {
-	T.addLast(e); // add e to heap
-	Position v = T.last(); // e's pos
 	while (!T.isRoot(v)) { // up-heap bubbling
 		Position u = T.parent(v);
-		if (!isLess(*v, *u)) break; // if v in order, we're done
-		T.swap(v, u); // else swap with parent elem
+		if (!isLess(e, *u)) break; // if e in order, we're done
+		*v = std::move(*u); // else move the parent down into the hole
 		v = u;
 	}
+	*v = std::move(e);
 }
 
-template <class NodeType, class C>
-void HeapPriorityQueue<NodeType, C>::removeMin()
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::downHeap(Position u, NodeType e)
 {
-	if (size() == 1) // only one node
-		T.removeLast(); // remove it
-	else {
-		Position u = T.root(); // root pos
-		T.swap(u, T.last()); // swap last with root
-		T.removeLast(); 
-		while (T.hasLeft(u))
-		{ // down-heap bubbling
-			Position v = T.left(u);
-			if (T.hasRight(u) && isLess(*(T.right(u)), *v))
-				v = T.right(u); // v is u's smaller child
-			if (isLess(*v, *u)) { // is u out of order
-				T.swap(v, u); // then swap
-				u = v;
-			}
-			else break; // else we're done
-		}
+	while (T.hasLeft(u)) { // down-heap bubbling
+		Position v = T.minChild(u, isLess); // v is u's smallest child
+		if (!isLess(*v, e)) break; // if e in order, we're done
+		*u = std::move(*v); // else move the child up into the hole
+		u = v;
 	}
+	*u = std::move(e);
 }
 
-template <class NodeType, class C>
-void HeapPriorityQueue<NodeType, C>::display()
+// Floyd : down-heap every internal node, last one first
+template <class NodeType, class C, int D>
+void HeapPriorityQueue<NodeType, C, D>::heapify()
 {
-	T.display();
+	if (size() < 2)
+		return;
+	for (Position p = T.parent(T.last());; --p) {
+		downHeap(p, std::move(*p));
+		if (T.isRoot(p))
+			break;
+	}
 }
@@ -0,0 +1,186 @@
+#pragma once
+/**
+	Description :
+	Intrusive Doubly Linked List
+
+	The elements are their own nodes : a type joins a list by deriving
+	from ListHook<T, Tag>, which holds the next and prev pointers, and
+	the list links the objects where they already live (an arena, a
+	vector that no longer grows, the stack). Nothing is copied and
+	nothing is allocated, so insert, erase and unlinking an element
+	known by reference are all O(1) and cannot throw.
+
+	The list owns nothing : it must not outlive its elements, and an
+	element must be erased before it is destroyed. One hook per Tag, so
+	an object can sit in as many lists at once as it has hooks. Copying
+	an object does not copy its membership, the copy starts unlinked.
+
+	Same interface as LinkedList, with T& in place of values and T* as
+	the position. PriorityQueue<T, IntrusiveNodes<Tag>> keeps its
+	elements in an IntrusiveList<T, Tag>.
+**/
+
+#include <iostream> // cout
+#include <stdexcept> // std::runtime_error
+#include <utility> // std::swap
+
+template <class T, class Tag>
+class IntrusiveList;
+
+template <class T, class Tag = void>
+class ListHook {
+public:
+	ListHook() {}
+	ListHook(const ListHook&) {} // a copy is not a member of any list
+	ListHook& operator=(const ListHook&) { return *this; }
+private:
+	friend class IntrusiveList<T, Tag>;
+	T* next = nullptr;
+	T* prev = nullptr;
+};
+
+// the node allocator policy for PriorityQueue that uses the elements as nodes
+template <class Tag = void>
+struct IntrusiveNodes {};
+
+template <class T, class Tag = void>
+class IntrusiveList {
+public:
+	typedef T* Position;
+
+	IntrusiveList() {}
+	IntrusiveList(const IntrusiveList&) = delete; // an element has one hook per Tag
+	IntrusiveList& operator=(const IntrusiveList&) = delete;
+	IntrusiveList(IntrusiveList&& that) { swap(that); }
+	IntrusiveList& operator=(IntrusiveList&& that) { swap(that); return *this; }
+	~IntrusiveList(); // unlinks the elements that are left
+
+	void Display();
+	int size() { return n; }
+	bool empty() { return n == 0; }
+	void insertFront(T& item);
+	T& removeFront();
+	void insertBack(T& item);
+	T& removeBack();
+	T& erase(T& item); // unlink item, O(1)
+	T& erase(Position p) { return erase(*p); }
+	T& getHead() { return *head; }
+	T& getTail() { return *tail; }
+	void clear(); // unlink all elements
+
+	Position first() { return head; }
+	static Position next(Position p) { return hook(*p).next; }
+	static T& data(Position p) { return *p; }
+private:
+	static ListHook<T, Tag>& hook(T& e) { return static_cast<ListHook<T, Tag>&>(e); }
+	void swap(IntrusiveList& that);
+
+	T* head = nullptr;
+	T* tail = nullptr;
+	int n = 0; // element counter
+};
+
+// dtor
+template <class T, class Tag>
+IntrusiveList<T, Tag>::~IntrusiveList()
+{
+	if (n != 0)
+		clear();
+}
+
+template <class T, class Tag>
+void IntrusiveList<T, Tag>::swap(IntrusiveList<T, Tag>& that)
+{
+	std::swap(head, that.head);
+	std::swap(tail, that.tail);
+	std::swap(n, that.n);
+}
+
+// display
+template <class T, class Tag>
+void IntrusiveList<T, Tag>::Display()
+{
+	for (T* p = head; p != nullptr; p = hook(*p).next)
+		std::cout << *p << " ";
+}
+
+// insert_front
+template <class T, class Tag>
+void IntrusiveList<T, Tag>::insertFront(T& item)
+{
+	ListHook<T, Tag>& h = hook(item);
+	h.prev = nullptr;
+	h.next = head;
+	if (head != nullptr)
+		hook(*head).prev = &item;
+	else
+		tail = &item;
+	head = &item;
+	n++;
+}
+
+// insert_back
+template <class T, class Tag>
+void IntrusiveList<T, Tag>::insertBack(T& item)
+{
+	ListHook<T, Tag>& h = hook(item);
+	h.next = nullptr;
+	h.prev = tail;
+	if (tail != nullptr)
+		hook(*tail).next = &item;
+	else
+		head = &item;
+	tail = &item;
+	n++;
+}
+
+// remove_front
+template <class T, class Tag>
+T& IntrusiveList<T, Tag>::removeFront()
+{
+	if (head == nullptr)
+		throw std::runtime_error("Error: Empty List");
+	return erase(*head);
+}
+
+// remove_back
+template <class T, class Tag>
+T& IntrusiveList<T, Tag>::removeBack()
+{
+	if (tail == nullptr)
+		throw std::runtime_error("Error: Empty List");
+	return erase(*tail);
+}
+
+// erase, item must be in this list
+template <class T, class Tag>
+T& IntrusiveList<T, Tag>::erase(T& item)
+{
+	ListHook<T, Tag>& h = hook(item);
+	if (h.prev != nullptr)
+		hook(*h.prev).next = h.next;
+	else
+		head = h.next;
+	if (h.next != nullptr)
+		hook(*h.next).prev = h.prev;
+	else
+		tail = h.prev;
+	h.next = h.prev = nullptr;
+	n--;
+	return item;
+}
+
+// clear
+template <class T, class Tag>
+void IntrusiveList<T, Tag>::clear()
+{
+	if (head == nullptr)
+		throw std::runtime_error("Error: Empty List");
+	while (head != nullptr) {
+		ListHook<T, Tag>& h = hook(*head);
+		head = h.next;
+		h.next = h.prev = nullptr;
+	}
+	tail = nullptr;
+	n = 0;
+}
@@ -0,0 +1,207 @@
+#pragma once
+/**
+	Description :
+	K-Way Merge of Sorted Ranges and Streams
+
+	Inputs are either contiguous sorted ranges, read in place, or streams
+	that hand over a batch of sorted elements per refill() call, so the
+	per-element cost is a pointer bump and the source is only called once
+	per batch.
+
+	Engines :
+		LOSER_TREE	tournament tree of k - 1 losers plus the winner; every
+					node holds a copy of its key, so replaying a leaf walks
+					log2(k) contiguous entries without touching the inputs
+		HEAP		HeapPriorityQueue of (key, input) heads, one removeMin
+					and one insert per element
+
+	Equal keys come out in input order, so the merge is stable.
+
+	Usage :
+		KWayMerge<int> m;
+		m.addRange(a.data(), a.data() + a.size());
+		m.addStream([&](int* buf, size_t cap) { return fill(buf, cap); });
+		m.merge(std::back_inserter(out));
+**/
+
+#include <cstddef> // size_t
+#include <vector> // std::vector
+#include <functional> // std::function
+#include <utility> // std::swap
+
+#include "HeapPriorityQueue.hpp"
+
+template <class NodeType, class C = Compare<NodeType>>
+class KWayMerge
+{
+public:
+	enum Engine { LOSER_TREE, HEAP };
+	// refill(buf, cap) writes up to cap sorted elements, returns 0 at end
+	typedef std::function<size_t(NodeType*, size_t)> Refill;
+
+	explicit KWayMerge(Engine e = LOSER_TREE, size_t batch = 1024) : engine(e), batchSize(batch) {}
+
+	// add a sorted range, read in place, it must outlive merge()
+	void addRange(const NodeType* first, const NodeType* last);
+	// add a sorted stream, read batchSize elements at a time
+	void addStream(Refill refill);
+	int inputs() const { return static_cast<int>(in.size()); }
+
+	// merge every input into out, consumes the inputs
+	template <class OutputIt>
+	OutputIt merge(OutputIt out);
+private:
+	struct Input {
+		const NodeType* curr = nullptr;
+		const NodeType* end = nullptr;
+		Refill refill; // empty for ranges
+		std::vector<NodeType> buffer;
+	};
+
+	// tree entry, exhausted inputs sort after everything
+	struct Entry {
+		NodeType key;
+		int input;
+		bool done;
+	};
+
+	class EntryCompare {
+	public:
+		bool operator () (const Entry& x, const Entry& y) const
+		{
+			if (x.done || y.done)
+				return !x.done || (y.done && x.input < y.input);
+			if (isLess(x.key, y.key)) return true;
+			if (isLess(y.key, x.key)) return false;
+			return x.input < y.input;
+		}
+	private:
+		C isLess;
+	};
+
+	// move input i to its next element, false when it runs dry
+	bool advance(Input& i);
+	Entry head(int i);
+	int build(int node);
+
+	template <class OutputIt>
+	OutputIt mergeLoserTree(OutputIt out);
+	template <class OutputIt>
+	OutputIt mergeHeap(OutputIt out);
+
+	Engine engine;
+	size_t batchSize;
+	std::vector<Input> in;
+	std::vector<Entry> tree; // tree[0] winner, tree[1..k) losers
+	EntryCompare beats;
+};
+
+template <class NodeType, class C>
+void KWayMerge<NodeType, C>::addRange(const NodeType* first, const NodeType* last)
+{
+	Input i;
+	i.curr = first;
+	i.end = last;
+	in.push_back(std::move(i));
+}
+
+template <class NodeType, class C>
+void KWayMerge<NodeType, C>::addStream(Refill refill)
+{
+	Input i;
+	i.refill = refill;
+	i.buffer.resize(batchSize);
+	in.push_back(std::move(i));
+	advance(in.back()); // load the first batch
+}
+
+template <class NodeType, class C>
+bool KWayMerge<NodeType, C>::advance(Input& i)
+{
+	if (i.curr != i.end)
+		return true;
+	if (!i.refill)
+		return false;
+	size_t got = i.refill(i.buffer.data(), i.buffer.size());
+	i.curr = i.buffer.data();
+	i.end = i.curr + got;
+	return got > 0;
+}
+
+template <class NodeType, class C>
+typename KWayMerge<NodeType, C>::Entry KWayMerge<NodeType, C>::head(int i)
+{
+	if (in[i].curr == in[i].end)
+		return Entry{ NodeType(), i, true };
+	return Entry{ *in[i].curr, i, false };
+}
+
+// play the matches below node, store losers, return the winner's input
+template <class NodeType, class C>
+int KWayMerge<NodeType, C>::build(int node)
+{
+	int k = inputs();
+	if (node >= k) // leaf
+		return node - k;
+	int a = build(2 * node), b = build(2 * node + 1);
+	Entry x = head(a), y = head(b);
+	if (beats(x, y)) {
+		tree[node] = y;
+		return a;
+	}
+	tree[node] = x;
+	return b;
+}
+
+template <class NodeType, class C>
+template <class OutputIt>
+OutputIt KWayMerge<NodeType, C>::merge(OutputIt out)
+{
+	if (in.empty())
+		return out;
+	return engine == HEAP ? mergeHeap(out) : mergeLoserTree(out);
+}
+
+template <class NodeType, class C>
+template <class OutputIt>
+OutputIt KWayMerge<NodeType, C>::mergeLoserTree(OutputIt out)
+{
+	int k = inputs();
+	tree.assign(k, Entry{ NodeType(), 0, true });
+	tree[0] = head(k == 1 ? 0 : build(1));
+
+	while (!tree[0].done) {
+		Entry w = tree[0];
+		*out++ = w.key;
+		Input& src = in[w.input];
+		++src.curr;
+		w = advance(src) ? Entry{ *src.curr, w.input, false } : Entry{ NodeType(), w.input, true };
+		// replay from the winner's leaf to the root
+		for (int node = (w.input + k) / 2; node > 0; node /= 2)
+			if (beats(tree[node], w))
+				std::swap(tree[node], w);
+		tree[0] = w;
+	}
+	return out;
+}
+
+template <class NodeType, class C>
+template <class OutputIt>
+OutputIt KWayMerge<NodeType, C>::mergeHeap(OutputIt out)
+{
+	HeapPriorityQueue<Entry, EntryCompare> heads;
+	for (int i = 0; i < inputs(); i++)
+		if (in[i].curr != in[i].end)
+			heads.insert(head(i));
+
+	while (!heads.empty()) {
+		Entry w = heads.min();
+		heads.removeMin();
+		*out++ = w.key;
+		Input& src = in[w.input];
+		++src.curr;
+		if (advance(src))
+			heads.insert(Entry{ *src.curr, w.input, false });
+	}
+	return out;
+}
@@ -1,5 +1,10 @@
 #pragma once
 #include <iostream> // cin, cout
+#include <stdexcept> // std::runtime_error
+#include <type_traits> // std::is_trivially_destructible
+#include <unordered_set> // std::unordered_set
+#include <utility> // std::move, std::swap
+#include "NodeAllocator.hpp"
 
 template <class NodeType>
 struct Node {
@@ -8,12 +13,17 @@ struct Node {
 	Node<NodeType>* prev = nullptr;
 };
 
-template <class NodeType>
+// Alloc is the node allocator policy, see NodeAllocator.hpp
+template <class NodeType, class Alloc = NewNodeAllocator<NodeType>>
 class LinkedList {
 public:
-	LinkedList(); // copy ctor 
-	LinkedList<NodeType>(const LinkedList<NodeType>& that); // copy assignment
-	LinkedList<NodeType>& operator=(const LinkedList<NodeType>& that);
+	LinkedList(); // ctor
+	LinkedList(const LinkedList& that); // copy ctor
+	LinkedList& operator=(const LinkedList& that); // copy assignment
+	// move ctor, allocates nothing : that is left empty without a head node,
+	// which its next insert allocates
+	LinkedList(LinkedList&& that) noexcept;
+	LinkedList& operator=(LinkedList&& that) noexcept; // move assignment, swaps the nodes
 	virtual ~LinkedList(); // dtor
 
 	void Display();
@@ -26,121 +36,162 @@ public:
 	NodeType erase(Node<NodeType>* elem);
 	NodeType getHead() { return head->next->data; };
 	NodeType getTail() { return tail->data; };
-	void removeDup();
+	void removeDup(); // O(n^2), needs only ==
+	void removeDupHashed(); // O(n) expected, needs std::hash<NodeType>
+	void removeDupSorted(); // O(n), equal elements must be adjacent
+	// set operations, O(n + m) expected with std::hash<NodeType>; the
+	// order of this list is kept and its own duplicates are left alone
+	void unionWith(const LinkedList& that); // append what only that holds, once each
+	void intersectWith(const LinkedList& that); // keep what that holds too
+	void differenceWith(const LinkedList& that); // drop what that holds
+	// nodes are relinked, never copied, and that is left empty; O(1), or
+	// O(chunks) when this takes over the nodes of an unequal pool
+	void splice(LinkedList& that); // append every node of that
+	// merge that into this, both sorted, O(n + m); equal elements of this come first
+	void mergeSorted(LinkedList& that);
+	template <class C>
+	void mergeSorted(LinkedList& that, C isLess);
+	// stable bottom-up merge sort, O(n log n) and O(1) extra memory
+	void sort();
+	template <class C>
+	void sort(C isLess);
 	void clear(); // remove all nodes
 
-	template <class NodeType> // may not be needed
-	friend class PriorityQueue;
+	// walking the nodes, shared with IntrusiveList
+	typedef Node<NodeType>* Position;
+	Position first() { return firstNode(); }
+	static Position next(Position p) { return p->next; }
+	static NodeType& data(Position p) { return p->data; }
 private:
+	// the pool can drop every node at once when no destructor has to run
+	static constexpr bool BULK_CLEAR = Alloc::BULK_RELEASE && std::is_trivially_destructible<NodeType>::value;
+
+	// a moved-from list has no head node until it is needed
+	Node<NodeType>* firstNode() const { return head != nullptr ? head->next : nullptr; }
+	void makeHead();
+	Node<NodeType>* takeNodes(LinkedList& that); // that's chain, now freed by our allocator
+	void relink(); // prev links and tail from the next links
+	template <class C>
+	static Node<NodeType>* mergeChains(Node<NodeType>* a, Node<NodeType>* b, C isLess);
+
+	Alloc alloc;
 	Node<NodeType>* head = nullptr;
 	Node<NodeType>* tail = nullptr;
 	int n = 0; // node counter
 };
 
 // ctor
-template <class NodeType>
-LinkedList<NodeType>::LinkedList()
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>::LinkedList()
 {
-	head = new Node<NodeType>;
+	head = alloc.allocate();
 	head->prev = head->next = nullptr;
 	tail = head;
 }
 
 // copy ctor
-template <class NodeType>
-LinkedList<NodeType>::LinkedList(const LinkedList<NodeType>& that) 
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>::LinkedList(const LinkedList<NodeType, Alloc>& that) 
 {
-	if (that.head->next == nullptr)
-	{
-		head = new Node<NodeType>;
-		head->prev = head->next = nullptr;
-		tail = head;
-	}
-	else
+	head = alloc.allocate();
+	head->prev = head->next = nullptr;
+	tail = head;
+	Node<NodeType>* curr = head;
+	for (Node<NodeType>* thatObj = that.firstNode(); thatObj != nullptr; thatObj = thatObj->next)
 	{
-		head = new Node<NodeType>;
-		head->prev = nullptr;
-		Node<NodeType>* curr = head;
-		Node<NodeType>* thatHead = that.head; // may not be necessary, next line only could work
-		Node<NodeType>* thatObj = thatHead;
-		while (thatObj->next != nullptr)
-		{
-			curr->next = new Node<NodeType>;
-			curr->next->data = thatObj->next->data;
-			thatObj = thatObj->next;
-			curr = curr->next;
-			tail = curr;
-		}
+		curr->next = alloc.allocate();
+		curr->next->data = thatObj->data;
+		curr->next->prev = curr;
+		curr = curr->next;
+		tail = curr;
 	}
+	n = that.n;
 }
 
 // copy assignment
-template <class NodeType>
-LinkedList<NodeType>& LinkedList<NodeType>::operator=(const LinkedList<NodeType>& that)
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>& LinkedList<NodeType, Alloc>::operator=(const LinkedList<NodeType, Alloc>& that)
 {
 	if (this == &that) // check for self-assignment
 		return *this;
-	if (head->next != nullptr) // check if list already has values
-		this->clear();		   // if so, clear them
-	Node<NodeType>* thatObj = that.head;
+	if (!empty()) // check if list already has values
+		this->clear(); // if so, clear them
+	makeHead();
 	Node<NodeType>* curr = head;
-	while (thatObj->next != nullptr)
+	for (Node<NodeType>* thatObj = that.firstNode(); thatObj != nullptr; thatObj = thatObj->next)
 	{
-		curr->next = new Node<NodeType>;
-		curr->next->data = thatObj->next->data;
-		thatObj = thatObj->next;
+		curr->next = alloc.allocate();
+		curr->next->data = thatObj->data;
+		curr->next->prev = curr;
 		curr = curr->next;
 		tail = curr;
 	}
+	n = that.n;
 	return *this;
 }
 
+// move ctor
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>::LinkedList(LinkedList<NodeType, Alloc>&& that) noexcept
+{
+	*this = std::move(that); // swaps with our empty state, head stays nullptr
+}
+
+// move assignment
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>& LinkedList<NodeType, Alloc>::operator=(LinkedList<NodeType, Alloc>&& that) noexcept
+{
+	alloc.swap(that.alloc); // each allocator travels with its nodes
+	std::swap(head, that.head);
+	std::swap(tail, that.tail);
+	std::swap(n, that.n);
+	return *this;
+}
 
 // dtor
-template <class NodeType>
-LinkedList<NodeType>::~LinkedList()
+template <class NodeType, class Alloc>
+LinkedList<NodeType, Alloc>::~LinkedList()
 {
+	if (BULK_CLEAR || head == nullptr)
+		return; // the allocator frees its chunks, or moved from
 	Node<NodeType>* p = head;
 	while (head->next)
 	{
 		head = head->next;
-		delete p;
+		alloc.deallocate(p);
 		p = head;
 	}
-	delete head;
+	alloc.deallocate(head);
 }
 
 // display
-template <class NodeType>
-void LinkedList<NodeType>::Display()
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::Display()
 {
-	Node<NodeType>* p = head; // use p so head won't fail condition in dtor
-	while (p->next != nullptr)      // head->next would have set head to nullptr
-	{
-		std::cout << p->next->data << " ";
-		p = p->next;
-	}
+	for (Node<NodeType>* p = firstNode(); p != nullptr; p = p->next)
+		std::cout << p->data << " ";
 }
 
 // size
-template <class NodeType>
-int LinkedList<NodeType>::size()
+template <class NodeType, class Alloc>
+int LinkedList<NodeType, Alloc>::size()
 {
 	return n;
 }
 
 // empty
-template <class NodeType>
-bool LinkedList<NodeType>::empty()
+template <class NodeType, class Alloc>
+bool LinkedList<NodeType, Alloc>::empty()
 {
 	return head == tail;
 }
 
 // insert_front
-template <class NodeType>
-void LinkedList<NodeType>::insertFront(const NodeType& item)
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::insertFront(const NodeType& item)
 {
-	Node<NodeType>* t = new Node<NodeType>;
+	makeHead();
+	Node<NodeType>* t = alloc.allocate();
 	t->data = item;
 	if (head->next == nullptr) // if list does not contain nodes
 	{
@@ -160,10 +211,11 @@ void LinkedList<NodeType>::insertFront(const NodeType& item)
 }
 
 // insert_back
-template <class NodeType>
-void LinkedList<NodeType>::insertBack(const NodeType& item)
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::insertBack(const NodeType& item)
 {
-	Node<NodeType>* t = new Node<NodeType>;
+	makeHead();
+	Node<NodeType>* t = alloc.allocate();
 	t->data = item;
 	if (head->next == nullptr) // if list does not contain nodes
 	{
@@ -183,12 +235,12 @@ void LinkedList<NodeType>::insertBack(const NodeType& item)
 }
 
 // remove_front
-template <class NodeType>
-NodeType LinkedList<NodeType>::removeFront()
+template <class NodeType, class Alloc>
+NodeType LinkedList<NodeType, Alloc>::removeFront()
 {
 	NodeType x;
 	Node<NodeType>* p = head;
-	if (head->next != nullptr) // if list contains nodes
+	if (!empty()) // if list contains nodes
 	{
 		p = p->next;
 		x = p->data;
@@ -196,102 +248,108 @@ NodeType LinkedList<NodeType>::removeFront()
 		{
 			p->next->prev = p->prev;
 			p->prev->next = p->next;
-			delete(p);
+			alloc.deallocate(p);
 			n--;
 		}
 		else // if p at tail
 		{
 			p->prev->next = nullptr;
 			tail = head;
-			delete(p);
+			alloc.deallocate(p);
 			n--;
 		}
 		return x;
 	}
 	else
 	{
-		throw std::exception("Error: Empty List");
+		throw std::runtime_error("Error: Empty List");
 	}
 }
 
 // remove_back
-template <class NodeType>
-NodeType LinkedList<NodeType>::removeBack()
+template <class NodeType, class Alloc>
+NodeType LinkedList<NodeType, Alloc>::removeBack()
 {
-	if (head->next != nullptr) //if list contain nodes
+	if (!empty()) //if list contain nodes
 	{
 		NodeType x;
 		Node<NodeType>* p = tail;
 		x = tail->data;
 		tail = tail->prev;
 		tail->next = nullptr;
-		delete(p);
+		alloc.deallocate(p);
 		n--;
 		return x;
 	}
 	else // if list does not contain nodes
 	{
-		throw std::exception("Error: Empty List");
+		throw std::runtime_error("Error: Empty List");
 	}
 }
 
 //erase
-template <class NodeType>
-NodeType LinkedList<NodeType>::erase(Node<NodeType>* minPtr) // used with PriorityQueue to delete min elem at any position
+template <class NodeType, class Alloc>
+NodeType LinkedList<NodeType, Alloc>::erase(Node<NodeType>* minPtr) // used with PriorityQueue to delete min elem at any position
 {
 	NodeType x = minPtr->data;;
-	if (head->next != nullptr) // if list contains nodes
+	if (!empty()) // if list contains nodes
 	{
 		if (minPtr->next) // if min_ptr not at tail
 		{
 			minPtr->next->prev = minPtr->prev;
 			minPtr->prev->next = minPtr->next;
-			delete(minPtr);
+			alloc.deallocate(minPtr);
 			n--;
 		}
 		else // if min_ptr at tail
 		{
 			minPtr->prev->next = nullptr;
 			tail = minPtr->prev;
-			delete(minPtr);
+			alloc.deallocate(minPtr);
 			n--;
 		}
 		return x;
 	}
 	else
 	{
-		throw std::exception("Error: Empty List");
+		throw std::runtime_error("Error: Empty List");
 	}
 }
 
 
 //clear
-template <class NodeType>
-void LinkedList<NodeType>::clear() // does not delete head, only the data nodes
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::clear() // does not delete head, only the data nodes
 {
 	Node<NodeType>* p = head;
-	if (head->next != nullptr) { // if list contains nodes
+	if (!empty() && BULK_CLEAR) { // drop every node, O(1) for the pool
+		alloc.releaseAll();
+		head = alloc.allocate();
+		tail = head;
+		n = 0;
+	}
+	else if (!empty()) { // if list contains nodes
 		while (head->next != nullptr)
 		{
 			head = head->next;
 			head->prev = nullptr;
-			delete(p);
+			alloc.deallocate(p);
 			n--;
 			p = head;
 		}
 	}
 	else
 	{
-		throw std::exception("Error: Empty List");
+		throw std::runtime_error("Error: Empty List");
 	}
 }
 
 // remove_dup
-template <class NodeType>
-void LinkedList<NodeType>::removeDup()
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::removeDup()
 {
-	Node<NodeType>* ptr1 = this->head->next;
-	Node<NodeType>* ptr2, * dup;
+	Node<NodeType>* ptr1 = firstNode();
+	Node<NodeType>* ptr2;
 
 	// access each element
 	while (ptr1 != nullptr && ptr1->next != nullptr)
@@ -301,14 +359,9 @@ void LinkedList<NodeType>::removeDup()
 		// compare the selected element with the rest
 		while (ptr2->next != nullptr)
 		{
-			// if dup, delete
+			// if dup, delete (erase keeps prev, tail and n)
 			if (ptr1->data == ptr2->next->data)
-			{
-				dup = ptr2->next;
-				ptr2->next->prev = ptr2;
-				tail = ptr2->next = ptr2->next->next;
-				delete(dup);
-			}
+				erase(ptr2->next);
 			else
 				ptr2 = ptr2->next;
 		}
@@ -316,4 +369,244 @@ void LinkedList<NodeType>::removeDup()
 	}
 }
 
+// remove_dup, one pass remembering the values seen
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::removeDupHashed()
+{
+	std::unordered_set<NodeType> seen;
+	seen.reserve(n);
+	Node<NodeType>* p = firstNode();
+	while (p != nullptr)
+	{
+		Node<NodeType>* next = p->next;
+		if (!seen.insert(p->data).second)
+			erase(p);
+		p = next;
+	}
+}
+
+// remove_dup, sorted input : a duplicate follows its first copy
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::removeDupSorted()
+{
+	Node<NodeType>* p = firstNode();
+	while (p != nullptr && p->next != nullptr)
+	{
+		if (p->next->data == p->data)
+			erase(p->next);
+		else
+			p = p->next;
+	}
+}
+
+// union
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::unionWith(const LinkedList<NodeType, Alloc>& that)
+{
+	std::unordered_set<NodeType> seen;
+	seen.reserve(n + that.n);
+	for (Node<NodeType>* p = firstNode(); p != nullptr; p = p->next)
+		seen.insert(p->data);
+	Node<NodeType>* end = that.tail; // stop there if that is this list
+	for (Node<NodeType>* p = that.head; p != end; )
+	{
+		p = p->next;
+		if (seen.insert(p->data).second)
+			insertBack(p->data);
+	}
+}
+
+// intersection
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::intersectWith(const LinkedList<NodeType, Alloc>& that)
+{
+	if (this == &that)
+		return;
+	std::unordered_set<NodeType> other;
+	other.reserve(that.n);
+	for (Node<NodeType>* p = that.firstNode(); p != nullptr; p = p->next)
+		other.insert(p->data);
+	Node<NodeType>* p = firstNode();
+	while (p != nullptr)
+	{
+		Node<NodeType>* next = p->next;
+		if (other.count(p->data) == 0)
+			erase(p);
+		p = next;
+	}
+}
+
+// difference
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::differenceWith(const LinkedList<NodeType, Alloc>& that)
+{
+	std::unordered_set<NodeType> other;
+	other.reserve(that.n);
+	for (Node<NodeType>* p = that.firstNode(); p != nullptr; p = p->next)
+		other.insert(p->data);
+	Node<NodeType>* p = firstNode();
+	while (p != nullptr)
+	{
+		Node<NodeType>* next = p->next;
+		if (other.count(p->data) != 0)
+			erase(p);
+		p = next;
+	}
+}
+
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::makeHead()
+{
+	if (head != nullptr)
+		return;
+	head = alloc.allocate();
+	head->prev = head->next = nullptr;
+	tail = head;
+}
+
+template <class NodeType, class Alloc>
+Node<NodeType>* LinkedList<NodeType, Alloc>::takeNodes(LinkedList<NodeType, Alloc>& that)
+{
+	Node<NodeType>* first = that.head->next;
+	that.head->next = nullptr;
+	that.tail = that.head;
+	that.n = 0;
+	if (alloc != that.alloc) // take the whole pool, that is left without a head
+	{
+		alloc.adopt(that.alloc);
+		alloc.deallocate(that.head);
+		that.head = that.tail = nullptr;
+	}
+	return first;
+}
+
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::relink()
+{
+	Node<NodeType>* prev = head;
+	for (Node<NodeType>* p = head->next; p != nullptr; p = p->next)
+	{
+		p->prev = prev;
+		prev = p;
+	}
+	tail = prev;
+}
 
+// merge two null-terminated chains on their next links, a first on ties
+template <class NodeType, class Alloc>
+template <class C>
+Node<NodeType>* LinkedList<NodeType, Alloc>::mergeChains(Node<NodeType>* a, Node<NodeType>* b, C isLess)
+{
+	Node<NodeType>* merged = nullptr;
+	Node<NodeType>** link = &merged;
+	while (a != nullptr && b != nullptr)
+	{
+		if (isLess(b->data, a->data))
+		{
+			*link = b;
+			b = b->next;
+		}
+		else
+		{
+			*link = a;
+			a = a->next;
+		}
+		link = &(*link)->next;
+	}
+	*link = a != nullptr ? a : b;
+	return merged;
+}
+
+// splice
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::splice(LinkedList<NodeType, Alloc>& that)
+{
+	if (this == &that || that.empty())
+		return;
+	makeHead();
+	int m = that.n;
+	Node<NodeType>* last = that.tail;
+	Node<NodeType>* first = takeNodes(that);
+	tail->next = first;
+	first->prev = tail;
+	tail = last;
+	n += m;
+}
+
+// merge_sorted
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::mergeSorted(LinkedList<NodeType, Alloc>& that)
+{
+	mergeSorted(that, [](const NodeType& x, const NodeType& y) { return x < y; });
+}
+
+template <class NodeType, class Alloc>
+template <class C>
+void LinkedList<NodeType, Alloc>::mergeSorted(LinkedList<NodeType, Alloc>& that, C isLess)
+{
+	if (this == &that || that.empty())
+		return;
+	makeHead();
+	int m = that.n;
+	Node<NodeType>* b = takeNodes(that);
+	head->next = mergeChains(head->next, b, isLess);
+	n += m;
+	relink();
+}
+
+// sort
+template <class NodeType, class Alloc>
+void LinkedList<NodeType, Alloc>::sort()
+{
+	sort([](const NodeType& x, const NodeType& y) { return x < y; });
+}
+
+// runs of width 1, 2, 4, ... merged pairwise along the next links until
+// one pass does a single merge; prev links are rebuilt once at the end
+template <class NodeType, class Alloc>
+template <class C>
+void LinkedList<NodeType, Alloc>::sort(C isLess)
+{
+	if (empty() || head->next->next == nullptr)
+		return;
+	Node<NodeType>* list = head->next;
+	for (int width = 1;; width *= 2)
+	{
+		Node<NodeType>* p = list;
+		Node<NodeType>** link = &list;
+		int merges = 0;
+		while (p != nullptr)
+		{
+			merges++;
+			Node<NodeType>* q = p; // q starts width nodes after p
+			int pSize = 0;
+			for (; pSize < width && q != nullptr; pSize++)
+				q = q->next;
+			int qSize = width;
+			while (pSize > 0 || (qSize > 0 && q != nullptr))
+			{
+				Node<NodeType>* e;
+				if (pSize == 0 || (qSize > 0 && q != nullptr && isLess(q->data, p->data)))
+				{
+					e = q;
+					q = q->next;
+					qSize--;
+				}
+				else
+				{
+					e = p;
+					p = p->next;
+					pSize--;
+				}
+				*link = e;
+				link = &e->next;
+			}
+			p = q;
+		}
+		*link = nullptr;
+		if (merges <= 1)
+			break;
+	}
+	head->next = list;
+	relink();
+}
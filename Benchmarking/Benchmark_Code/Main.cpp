@@ -5,35 +5,154 @@
  *	 PROGRAM DESCRIPTION:	Program to benchmark the runtime of various algorithms 
  *							on various data structures. 
  *
- *	 DATA STRUCTURES:		LL-Based PQ, STL PQ, Vector Based Min Heap
- *							STL std::make_heap()
+ *	 DATA STRUCTURES:		Skip List PQ, STL PQ, Vector Based Min Heap
+ *							LinkedList node churn (new / delete vs pooled nodes)
+ *							Unrolled Linked List (16 ints per node) vs LinkedList
+ *							Intrusive List (records linked in their arena) vs LinkedList
+ *							STL std::make_heap(), d-ary (2, 4, 8, 16) Min Heaps
+ *							Radix Heap, Bucket (Calendar) Queue
+ *							Pairing Heap (pooled nodes, meld of shard queues)
+ *							Min-Max Heap vs two heaps with lazy cross-deletion
+ *							Addressable Heap (decrease-key handles)
+ *							MultiQueue (relaxed concurrent PQ) vs global mutex heap
+ *							Skip List PQ, lock-free concurrent inserts
+ *							Lock-free MPMC queue (hazard pointers) vs mutex LinkedList
  *
  *	 ALGORITHMS:			PQ Sort, STL PQ Sort, Heap Sort, STL Heap Sort
  *							Merge Sort, Bubble Sort, STL Quick Sort
+ *							Adaptive Sort (natural runs, powersort merges)
+ *							Parallel Sample Sort (work stealing), strong scaling
+ *							Record Sort (direct, indirect key-index, packed)
+ *							K-Way Merge (Loser Tree, Heap, Pairwise merge())
+ *							Dijkstra (decrease-key vs lazy deletion)
+ *							Selection of the k smallest (introselect, partial sort,
+ *							streaming top-k) against full sort + truncate
+ *							LinkedList duplicate removal (scan, hashed, sorted)
+ *							and set operations (union, intersection, difference)
+ *							LinkedList in-place merge sort, mergeSorted(), splice()
+ *							against copying through a vector or node by node
+ *
+ *	 INPUTS:				every algorithm runs on every distribution in
+ *							Distributions.hpp (uniform, sorted, reverse, ...),
+ *							Dijkstra once on a seeded random graph
  *
  *	 SPECIFICATIONS:		C++, Windows 10, intel Core i7 10th Gen, 4 Cores
  *							8 Logical Processors, L1 L2 L3 cache
+ *
+ *	 MEMORY:				build with TRACK_ALLOCATIONS defined to add allocation
+ *							count, bytes, peak live bytes and bytes per element
+ *							for every row (AllocTracker.hpp)
+ *
+ *	 OPTIONS:				--perf          read hardware counters (Linux perf_event_open)
+ *							                around each timed region, reported per element
+ *							--n <count>     sample size (default 10)
+ *							--seed <seed>   generator seed (default 1)
+ *							--dist <name>   only this distribution, may be repeated
+ *							--write <file>  stream --n elements of the first distribution
+ *							                to a binary file instead of benchmarking
+ *							--external-sort <in> <out>
+ *							                sort a binary file of ints larger than RAM
+ *							--memory <MB>   external sort memory budget (default 256)
+ *							--temp <dir>    external sort run directory (default .)
+ *							--threads <t>   external sort and sample sort threads (default all cores)
+ *							--direct        external sort with O_DIRECT I/O (Linux)
+ *							--heap-max <count>
+ *							                also run the d-ary heap rows at 10^6, 10^7, ...
+ *							                up to count elements (default n only); the int
+ *							                4-, 8- and 16-ary rows scan children with SSE4.1
+ *							                when built with -msse4.1 or -march=native (GCC,
+ *							                Clang) or /arch:AVX, /arch:AVX2 (MSVC), labelled
+ *							                "SSE4.1", else with the scalar loop
  * 
  **/
 
 #include <algorithm> // stl quick_sort
 #include <queue> // stl priority_queue
-#include <ctime> // std::time
-#include <random> // srand (), rand ()
+#include <cstdlib> // std::strtoull
+#include <cstdint> // uint64_t
+#include <climits> // INT_MAX
 #include <chrono> // high_resolution clock
 #include <iostream> // std::cout 
 #include <iomanip>
+#include <string> // std::string
+#include <sstream> // std::ostringstream
+#include <thread> // std::thread
+#include <mutex> // std::mutex
+#include <atomic> // std::atomic
+#include <iterator> // std::back_inserter
+#include <memory> // std::unique_ptr
 
 #include "PriorityQueue.hpp"
 #include "HeapPriorityQueue.hpp"
+#include "PerfCounters.hpp"
+#include "AllocTracker.hpp"
+#include "Distributions.hpp"
+#include "ExternalSort.hpp"
+#include "KWayMerge.hpp"
+#include "AdaptiveSort.hpp"
+#include "SampleSort.hpp"
+#include "RecordSort.hpp"
+#include "Selection.hpp"
+#include "AddressableHeap.hpp"
+#include "MultiQueue.hpp"
+#include "RadixHeap.hpp"
+#include "BucketQueue.hpp"
+#include "PairingHeap.hpp"
+#include "MinMaxHeap.hpp"
+#include "UnrolledLinkedList.hpp"
+#include "SkipListPriorityQueue.hpp"
+#include "ConcurrentQueue.hpp"
+#include "IntrusiveList.hpp"
 
 void iterMergeSort(std::vector<int>& sorted, int* L, int* R, int n); // Adapted Merge Sort From GeeksForGeeks
 void merge(std::vector<int>& sorted, int* L, int* R, int l, int m, int h);
 void bubbleSort(std::vector<int>& sorted);
 void swap(int* x, int* y);
+void pairwiseMerge(std::vector<int>& sorted, std::vector<int> bounds);
+void printHeader(const std::string& title, const PerfCounters& counters, const AllocCounters& allocs);
+void printResult(const std::string& label, std::chrono::high_resolution_clock::duration elapsed,
+	const PerfCounters& counters, const AllocCounters& allocs, int n);
+int ruleWidth(const PerfCounters& counters, const AllocCounters& allocs);
+// reversed Compare, for max-heaps
+template <class NodeType>
+class Greater {
+public:
+	bool operator () (const NodeType& x, const NodeType& y) const {
+		return y < x;
+	}
+};
 
+struct ArenaRecord : ListHook<ArenaRecord> { // a 64 byte record with its own list hook
+	int key;
+	char payload[44];
+	bool operator < (const ArenaRecord& that) const { return key < that.key; }
+};
 
-int main()
+struct QueueEvent { // one logged concurrent PQ operation
+	uint64_t ticket;
+	int value;
+	bool removal;
+};
+double meanRankError(std::vector<QueueEvent>& events);
+template <class F>
+void runThreads(unsigned threads, const F& body);
+template <class Push, class Pop>
+long long runProducersConsumers(unsigned threads, const std::vector<int>& input, const Push& push, const Pop& pop);
+void randomGraph(int vertices, int degree, uint64_t seed,
+	std::vector<int>& offsets, std::vector<int>& targets, std::vector<int>& weights);
+void dijkstraAddressable(const std::vector<int>& offsets, const std::vector<int>& targets,
+	const std::vector<int>& weights, std::vector<long long>& dist, int& peak);
+void dijkstraLazy(const std::vector<int>& offsets, const std::vector<int>& targets,
+	const std::vector<int>& weights, std::vector<long long>& dist, int& peak);
+template <int D>
+void benchDaryHeap(const std::vector<int>& input, PerfCounters& counters, AllocCounters& allocs);
+template <class Alloc>
+void benchListChurn(const std::vector<int>& input, const std::string& name, PerfCounters& counters, AllocCounters& allocs);
+template <class List>
+void benchListOps(const std::vector<int>& input, const std::string& name, PerfCounters& counters, AllocCounters& allocs);
+
+
+int main(int argc, char* argv[])
 {
 	/*
 	* -------------------------------------------------------------------------------
@@ -41,218 +160,1414 @@ int main()
 	*  ------------------------------------------------------------------------------
 	*/
 
-	int SAMPLES = 10; 	// declare sample size
-	std::vector<int> sorted; // vector to store sorted results
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));	// current time as seed for random generator
-
-	// print header
-	std::cout << "************************************************************************" << std::endl;
-	std::cout << "SAMPLE SIZE: " << SAMPLES << std::endl;
-	std::cout << std::setw(50) << std::left << "DATA STRUCTURE"
-		<< std::setw(20) << std::right << "RUNTIME" << std::endl;
-	std::cout << "************************************************************************" << std::endl;
+	uint64_t count = 10; // requested sample size, may exceed int for --write
+	DistributionParams params; // seeded so every run sees the same inputs
+	std::vector<Distribution> distributions; // distribution matrix, all unless --dist
+	std::string writePath;
+	std::string sortIn, sortOut; // --external-sort
+	ExternalSortConfig external;
+	uint64_t heapMax = 0; // largest d-ary heap sweep size
 
+	// hardware counters are opt-in, the table falls back to wall time only
+	PerfCounters counters;
+	AllocCounters allocs; // live only with TRACK_ALLOCATIONS
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--perf") {
+			if (!counters.open())
+				std::cerr << "perf counters unavailable (" << counters.error() << "), reporting wall time only" << std::endl;
+		}
+		else if (arg == "--n" && i + 1 < argc)
+			count = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--seed" && i + 1 < argc)
+			params.seed = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--dist" && i + 1 < argc) {
+			Distribution d = distributionFromName(argv[++i]);
+			if (d == NUM_DISTRIBUTIONS) {
+				std::cerr << "unknown distribution " << argv[i] << std::endl;
+				return 1;
+			}
+			distributions.push_back(d);
+		}
+		else if (arg == "--write" && i + 1 < argc)
+			writePath = argv[++i];
+		else if (arg == "--external-sort" && i + 2 < argc) {
+			sortIn = argv[++i];
+			sortOut = argv[++i];
+		}
+		else if (arg == "--memory" && i + 1 < argc)
+			external.memoryBudget = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)) << 20;
+		else if (arg == "--temp" && i + 1 < argc)
+			external.tempDir = argv[++i];
+		else if (arg == "--threads" && i + 1 < argc)
+			external.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+		else if (arg == "--direct")
+			external.directIO = true;
+		else if (arg == "--heap-max" && i + 1 < argc)
+			heapMax = std::strtoull(argv[++i], nullptr, 10);
+		else {
+			std::cerr << "unknown option " << arg << std::endl;
+			return 1;
+		}
+	}
+	if (distributions.empty())
+		for (int d = 0; d < NUM_DISTRIBUTIONS; d++)
+			distributions.push_back(static_cast<Distribution>(d));
 
 	/*
 	* -------------------------------------------------------------------------------
-	*		Linked List Based PriorityQueue
+	*		Write a Distribution to Disk (inputs larger than RAM)
 	*  ------------------------------------------------------------------------------
 	*/
-	PriorityQueue<int> pq;
-	// insert
-	for (int i = 0; i < SAMPLES; i++)
-		pq.insert(std::rand() % 1000 + 1);
-	// sort
-	auto start = std::chrono::high_resolution_clock::now();
-	while (!pq.isEmpty()) {
-		sorted.push_back(pq.min()); pq.removeMin();
+	if (!writePath.empty()) {
+		auto start = std::chrono::high_resolution_clock::now();
+		bool ok = writeDistribution(writePath, distributions.front(), count, params);
+		auto stop = std::chrono::high_resolution_clock::now();
+		if (!ok) {
+			std::cerr << "could not write " << writePath << std::endl;
+			return 1;
+		}
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		std::cout << "wrote " << count << " " << distributionName(distributions.front()) << " ints to " << writePath
+			<< " at " << std::fixed << std::setprecision(2) << count * sizeof(int) / seconds / 1e6 << " MB/s" << std::endl;
+		return 0;
 	}
-	auto stop = std::chrono::high_resolution_clock::now();
-	// print runtime result
-	std::cout << std::setw(50) << std::left << "Linked List Based Priority Queue  "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
-	// for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
 	/*
 	* -------------------------------------------------------------------------------
-	*		STL Priority Queue (Deque)
+	*		External Merge Sort (inputs larger than RAM)
 	*  ------------------------------------------------------------------------------
 	*/
-	std::priority_queue<int, std::deque<int>> stlPQ;
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));
-	sorted.clear();
-
-	// insert
-	for (int i = 0; i < SAMPLES; i++)
-		stlPQ.push(std::rand() % 1000 + 1);
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	while (!stlPQ.empty()) {
-		sorted.push_back(stlPQ.top()); stlPQ.pop();
+	if (!sortIn.empty()) {
+		ExternalSortStats stats;
+		try {
+			stats = externalSort(sortIn, sortOut, external);
+		}
+		catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+		std::cout << std::fixed << std::setprecision(2)
+			<< "sorted " << stats.elements << " ints in " << stats.runs << " runs, " << stats.passes << " merge passes" << std::endl
+			<< std::setw(30) << std::left << "run formation " << std::setw(10) << std::right << stats.runMBps() << " MB/s" << std::endl
+			<< std::setw(30) << std::left << "k-way merge " << std::setw(10) << std::right << stats.mergeMBps() << " MB/s" << std::endl
+			<< std::setw(30) << std::left << "total " << std::setw(10) << std::right << stats.totalMBps() << " MB/s" << std::endl;
+		return 0;
 	}
-	stop = std::chrono::high_resolution_clock::now();
-	//print runtime results
-	std::cout << std::setw(50) << std::left << "STL Priority Queue  "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
-	//for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
+	// the in-memory structures index with int, only --write and --external-sort go beyond
+	if (count > static_cast<uint64_t>(INT_MAX)) {
+		std::cerr << "--n " << count << " is larger than " << INT_MAX
+			<< " for the in-memory benchmark, use --write and --external-sort" << std::endl;
+		return 1;
+	}
+	if (count == 0) { // the sections pop, clear and take % SAMPLES of a non-empty input
+		std::cerr << "--n must be at least 1 for the in-memory benchmark" << std::endl;
+		return 1;
+	}
+	int SAMPLES = static_cast<int>(count); 	// declare sample size
+	std::vector<int> input; // generated input, copied into every structure
+	std::vector<int> sorted; // vector to store sorted results
+	WorkStealingPool pool(external.threads); // after --perf, so the workers inherit the counters
 
-	/*
-	* -------------------------------------------------------------------------------
-	*		Vector Based Min Heap
-	*  ------------------------------------------------------------------------------
-	*/
+	for (Distribution dist : distributions) {
+		generateDistribution(dist, input, SAMPLES, params);
+		sorted.clear();
 
-	HeapPriorityQueue<int, Compare<int>> minHeap;
-	sorted.clear();
+		// print header
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    DISTRIBUTION: " + distributionName(dist), counters, allocs);
 
-	// insert
-	for (int i = 0; i < SAMPLES; i++)
-		minHeap.insert(std::rand() % 1000 + 1);
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	while (!minHeap.empty()) {
-		sorted.push_back(minHeap.min());
-		minHeap.removeMin();
-	}
-	stop = std::chrono::high_resolution_clock::now();
-	// print runtime results
-	std::cout << std::setw(50) << std::left << "Vector Based Min Heap "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
-	//for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
+		/*
+		* -------------------------------------------------------------------------------
+		*		Skip List Based PriorityQueue
+		*  ------------------------------------------------------------------------------
+		*/
+		SkipListPriorityQueue<int> pq;
+		allocs.start();
+		// insert
+		for (int i = 0; i < SAMPLES; i++)
+			pq.insert(input[i]);
+		// sort
+		auto start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		while (!pq.empty()) {
+			sorted.push_back(pq.min()); pq.removeMin();
+		}
+		counters.stop();
+		allocs.stop();
+		auto stop = std::chrono::high_resolution_clock::now();
+		// print runtime result
+		printResult("Skip List Priority Queue", stop - start, counters, allocs, SAMPLES);
+		// for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
-	/*
-	* -------------------------------------------------------------------------------
-	*		std::make_heap()
-	*  ------------------------------------------------------------------------------
-	*/
-	std::vector<int> stlHeap;
-	sorted.clear();
-
-	// insert elements in vector
-	for (int i = 0; i < SAMPLES; i++)
-		stlHeap.push_back(std::rand() % 1000 + 1);
-	// convert vector to heap with std::make_heap
-	std::make_heap(stlHeap.begin(), stlHeap.end());
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	while (!stlHeap.empty()) {
-		sorted.push_back(stlHeap.front());
-		std::pop_heap(stlHeap.begin(), stlHeap.end()); // pop element and place at end of list
-		stlHeap.pop_back(); // remove from end of list
-	}
-	stop = std::chrono::high_resolution_clock::now();
+		/*
+		* -------------------------------------------------------------------------------
+		*		STL Priority Queue (Deque)
+		*  ------------------------------------------------------------------------------
+		*/
+		std::priority_queue<int, std::deque<int>> stlPQ;
+		sorted.clear();
 
-	// print runtime results
-	std::cout << std::setw(50) << std::left << "STL std::make_heap "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
-	// print sorted
-	// for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
-
-/*
-* -------------------------------------------------------------------------------
-*		Merge Sort on std::vector
-*  ------------------------------------------------------------------------------
-*/
-	int* L = nullptr;
-	int* R = nullptr;
+		allocs.start();
+		// insert
+		for (int i = 0; i < SAMPLES; i++)
+			stlPQ.push(input[i]);
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		while (!stlPQ.empty()) {
+			sorted.push_back(stlPQ.top()); stlPQ.pop();
+		}
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+		//print runtime results
+		printResult("STL Priority Queue", stop - start, counters, allocs, SAMPLES);
+		//for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
-	sorted.clear();
 
-	// insert elements in vector
-	for (int i = 0; i < SAMPLES; i++)
-		sorted.push_back(std::rand() % 1000 + 1);
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	iterMergeSort(sorted, L, R, SAMPLES);
-	stop = std::chrono::high_resolution_clock::now();
+		/*
+		* -------------------------------------------------------------------------------
+		*		Vector Based Min Heap
+		*  ------------------------------------------------------------------------------
+		*/
 
-	delete[] L;
-	delete[] R;
+		sorted.clear();
 
-	// print runtime results
-	std::cout << std::setw(50) << std::left << "Merge Sort on std::vector<int> "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
+		allocs.start();
+		// insert, O(n) bottom-up heapify
+		HeapPriorityQueue<int, Compare<int>> minHeap(input.begin(), input.end());
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		minHeap.drainSorted(std::back_inserter(sorted));
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+		// print runtime results
+		printResult("Vector Based Min Heap", stop - start, counters, allocs, SAMPLES);
+		//for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
+
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Monotone Radix Heap
+		*  ------------------------------------------------------------------------------
+		*/
+		RadixHeap<int> radixHeap;
+		sorted.clear();
+
+		allocs.start();
+		// insert
+		for (int i = 0; i < SAMPLES; i++)
+			radixHeap.insert(input[i]);
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		while (!radixHeap.empty()) {
+			sorted.push_back(radixHeap.min());
+			radixHeap.removeMin();
+		}
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+		// print runtime results
+		printResult("Monotone Radix Heap", stop - start, counters, allocs, SAMPLES);
+
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Bucket (Calendar) Queue
+		*  ------------------------------------------------------------------------------
+		*/
+		BucketQueue<int> bucketQueue;
+		sorted.clear();
 
-	//print sorted
-	//for (int i = 0; i < sorted.size(); i++) {
-	//	std::cout << i << " " << sorted[i] << std::endl;
-	//}
+		allocs.start();
+		// insert
+		for (int i = 0; i < SAMPLES; i++)
+			bucketQueue.insert(input[i]);
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		while (!bucketQueue.empty()) {
+			sorted.push_back(bucketQueue.min());
+			bucketQueue.removeMin();
+		}
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+		// print runtime results
+		printResult("Bucket (Calendar) Queue", stop - start, counters, allocs, SAMPLES);
+
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Pairing Heap
+		*  ------------------------------------------------------------------------------
+		*/
+		{
+			PairingHeap<int> pairingHeap;
+			sorted.clear();
+
+			allocs.start();
+			// insert
+			for (int i = 0; i < SAMPLES; i++)
+				pairingHeap.insert(input[i]);
+			// sort
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			while (!pairingHeap.empty()) {
+				sorted.push_back(pairingHeap.min());
+				pairingHeap.removeMin();
+			}
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			// print runtime results
+			printResult("Pairing Heap (pooled nodes)", stop - start, counters, allocs, SAMPLES);
+		}
+
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		std::make_heap()
+		*  ------------------------------------------------------------------------------
+		*/
+		std::vector<int> stlHeap;
+		sorted.clear();
+
+		allocs.start();
+		// insert elements in vector
+		stlHeap = input;
+		// convert vector to heap with std::make_heap
+		std::make_heap(stlHeap.begin(), stlHeap.end());
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		while (!stlHeap.empty()) {
+			sorted.push_back(stlHeap.front());
+			std::pop_heap(stlHeap.begin(), stlHeap.end()); // pop element and place at end of list
+			stlHeap.pop_back(); // remove from end of list
+		}
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+
+		// print runtime results
+		printResult("STL std::make_heap", stop - start, counters, allocs, SAMPLES);
+		// print sorted
+		// for (size_t i = 0; i < SAMPLES; i++) { std::cout << i << " " << sorted[i] << std::endl; }
 
 	/*
 	* -------------------------------------------------------------------------------
-	*		Bubble Sort on std::vector
+	*		Merge Sort on std::vector
 	*  ------------------------------------------------------------------------------
 	*/
-	sorted.clear();
+		int* L = nullptr;
+		int* R = nullptr;
 
-	// insert elements in vector
-	for (int i = 0; i < SAMPLES; i++)
-		sorted.push_back(std::rand() % 1000 + 1);
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	bubbleSort(sorted);
-	stop = std::chrono::high_resolution_clock::now();
+		allocs.start();
+		// insert elements in vector
+		sorted = input;
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		iterMergeSort(sorted, L, R, SAMPLES);
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
 
-	// print runtime results
-	std::cout << std::setw(50) << std::left << "Bubble Sort on std::vector<int> "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
+		delete[] L;
+		delete[] R;
+
+		// print runtime results
+		printResult("Merge Sort on std::vector<int>", stop - start, counters, allocs, SAMPLES);
+
+		//print sorted
+		//for (int i = 0; i < sorted.size(); i++) {
+		//	std::cout << i << " " << sorted[i] << std::endl;
+		//}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Bubble Sort on std::vector
+		*  ------------------------------------------------------------------------------
+		*/
+		allocs.start();
+		// insert elements in vector
+		sorted = input;
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		bubbleSort(sorted);
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+
+		// print runtime results
+		printResult("Bubble Sort on std::vector<int>", stop - start, counters, allocs, SAMPLES);
+
+
+		// print sorted results
+		//std::cout << "bubble sort: " << std::endl;
+		//for (auto i : sorted) {
+		//	std::cout << i << std::endl;
+		// }
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		STL Quick Sort on std::vector
+		*  ------------------------------------------------------------------------------
+		*/
+		allocs.start();
+		// insert elements in vector
+		sorted = input;
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		std::sort(sorted.begin(), sorted.end());
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+
+		// print runtime results
+		printResult("STL Quick Sort on std::vector<int>", stop - start, counters, allocs, SAMPLES);
+
+
+		// print sorted results
+		//std::cout << "STL quick_sort : " << std::endl;
+		//int sz = sorted.size();
+		//for (int i = 0; i < sz; i++) {
+		//	std::cout << i << " " << sorted[i] << std::endl;
+		//}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Adaptive Sort (Powersort) on std::vector
+		*  ------------------------------------------------------------------------------
+		*/
+		allocs.start();
+		// insert elements in vector
+		sorted = input;
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		adaptiveSort(sorted.begin(), sorted.end());
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+
+		// print runtime results
+		printResult("Adaptive Sort on std::vector<int>", stop - start, counters, allocs, SAMPLES);
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Parallel Sample Sort on std::vector (all pool threads)
+		*  ------------------------------------------------------------------------------
+		*/
+		allocs.start();
+		// insert elements in vector
+		sorted = input;
+		// sort
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		parallelSampleSort(sorted.begin(), sorted.end(), pool);
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+
+		// print runtime results
+		printResult("Sample Sort on std::vector<int>, " + std::to_string(pool.threads()) + " threads", stop - start, counters, allocs, SAMPLES);
+
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Sample Sort Strong Scaling, 1..N threads on the same input
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    SAMPLE SORT STRONG SCALING    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		std::vector<unsigned> threadCounts; // 1, 2, 4, ... and the full pool
+		for (unsigned t = 1; t < pool.threads(); t *= 2)
+			threadCounts.push_back(t);
+		threadCounts.push_back(pool.threads());
+		double oneThread = 0;
+		for (unsigned t : threadCounts) {
+			WorkStealingPool scaling(t);
+			sorted = input;
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			parallelSampleSort(sorted.begin(), sorted.end(), scaling);
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+			if (t == 1)
+				oneThread = ms;
+			std::ostringstream label;
+			label << "Sample Sort, " << t << " threads (speedup " << std::fixed << std::setprecision(2)
+				<< (ms > 0 ? oneThread / ms : 0) << "x)";
+			printResult(label.str(), stop - start, counters, allocs, SAMPLES);
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		K-Way Merge of k Sorted Runs (n elements in total)
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		for (int k : { 2, 16, 256, 10000 }) {
+			if (k > SAMPLES)
+				break;
+			// k sorted runs of n / k elements, bounds[r] is where run r starts
+			std::vector<int> runs = input;
+			std::vector<int> bounds;
+			for (int r = 0; r <= k; r++)
+				bounds.push_back(static_cast<int>(static_cast<long long>(SAMPLES) * r / k));
+			for (int r = 0; r < k; r++)
+				std::sort(runs.begin() + bounds[r], runs.begin() + bounds[r + 1]);
+
+			printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    K-WAY MERGE, k = " + std::to_string(k) + "    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+
+			// loser tree and heap engines
+			for (int e = 0; e < 2; e++) {
+				allocs.start();
+				KWayMerge<int> merger(e == 0 ? KWayMerge<int>::LOSER_TREE : KWayMerge<int>::HEAP);
+				for (int r = 0; r < k; r++)
+					merger.addRange(runs.data() + bounds[r], runs.data() + bounds[r + 1]);
+				sorted.resize(SAMPLES);
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				merger.merge(sorted.begin());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult(e == 0 ? "Loser Tree k-way Merge" : "HeapPriorityQueue k-way Merge", stop - start, counters, allocs, SAMPLES);
+			}
+
+			// repeated pairwise merge() of neighbouring runs
+			sorted = runs;
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			pairwiseMerge(sorted, bounds);
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("Repeated Pairwise merge()", stop - start, counters, allocs, SAMPLES);
+			std::cout << std::endl;
+		}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Record Sort, (ID, name) passenger records sorted by ID
+		*  ------------------------------------------------------------------------------
+		*/
+		typedef std::pair<int, std::string> Passenger;
+		typedef PackedRecord<int, 28> PackedPassenger; // 32 bytes
+		std::vector<Passenger> passengers;
+		for (int i = 0; i < SAMPLES; i++) // names longer than the small string buffer
+			passengers.push_back(Passenger(input[i], "Passenger Name " + std::to_string(i)));
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    RECORD SORT, std::pair<int, std::string>    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+
+		// sort the records themselves
+		{
+			std::vector<Passenger> records = passengers;
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			std::stable_sort(records.begin(), records.end(),
+				[](const Passenger& a, const Passenger& b) { return a.first < b.first; });
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("STL Stable Sort on Records", stop - start, counters, allocs, SAMPLES);
+		}
+		// sort (key, index) pairs, then permute the records by cycles
+		{
+			std::vector<Passenger> records = passengers;
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			sortByKeyIndirect(records, [](const Passenger& p) { return p.first; });
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("Indirect Key-Index Sort + Cycle Permute", stop - start, counters, allocs, SAMPLES);
+		}
+		// sort packed (key, payload) structs directly
+		{
+			std::vector<PackedPassenger> records;
+			for (auto& p : passengers)
+				records.push_back(packRecord<int, 28>(p.first, p.second));
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			sortPacked(records);
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("STL Sort on Packed 32-byte Records", stop - start, counters, allocs, SAMPLES);
+		}
+		std::cout << std::endl;
 
+		/*
+		* -------------------------------------------------------------------------------
+		*		Selection, the k smallest of n for k << n
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		std::vector<int> ks; // 10 and n / 100
+		if (SAMPLES > 10)
+			ks.push_back(10);
+		if (SAMPLES / 100 > 10)
+			ks.push_back(SAMPLES / 100);
+		for (int k : ks) {
+			printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    SELECTION, k = " + std::to_string(k) + "    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+
+			// full sort, keep the first k
+			{
+				sorted = input;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				std::sort(sorted.begin(), sorted.end());
+				sorted.resize(k);
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("STL Sort + Truncate", stop - start, counters, allocs, SAMPLES);
+			}
+			// insert everything, remove the first k
+			{
+				HeapPriorityQueue<int, Compare<int>> heap;
+				sorted.clear();
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int x : input)
+					heap.insert(x);
+				for (int i = 0; i < k; i++) {
+					sorted.push_back(heap.min());
+					heap.removeMin();
+				}
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Vector Min Heap, n inserts + k removeMin()", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				sorted = input;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				std::partial_sort(sorted.begin(), sorted.begin() + k, sorted.end());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("STL partial_sort", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				sorted = input;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				partialSort(sorted.begin(), sorted.begin() + k, sorted.end());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Partial Sort (introselect + sort k)", stop - start, counters, allocs, SAMPLES);
+			}
+			// k smallest in any order
+			{
+				sorted = input;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				std::nth_element(sorted.begin(), sorted.begin() + (k - 1), sorted.end());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("STL nth_element", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				sorted = input;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				introSelect(sorted.begin(), sorted.begin() + (k - 1), sorted.end());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Introselect", stop - start, counters, allocs, SAMPLES);
+			}
+			// one pass over the input as if it were a stream, O(k) memory
+			{
+				TopK<int> top(k);
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int x : input)
+					top.push(x);
+				sorted = top.sorted();
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Streaming Top-k (bounded heap)", stop - start, counters, allocs, SAMPLES);
+			}
+			std::cout << std::endl;
+		}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		d-ary Min Heaps, n inserts or heapify, then n removeMin() per arity
+		*  ------------------------------------------------------------------------------
+		*/
+		std::vector<int> heapSizes(1, SAMPLES);
+		for (uint64_t size = 1000000; size <= heapMax && size <= 1000000000; size *= 10)
+			if (size != static_cast<uint64_t>(SAMPLES))
+				heapSizes.push_back(static_cast<int>(size));
+		for (int size : heapSizes) {
+			std::vector<int> heapInput;
+			generateDistribution(dist, heapInput, size, params);
+			printHeader("SAMPLE SIZE: " + std::to_string(size) + "    D-ARY MIN HEAP    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+			benchDaryHeap<2>(heapInput, counters, allocs);
+			benchDaryHeap<4>(heapInput, counters, allocs);
+			benchDaryHeap<8>(heapInput, counters, allocs);
+			benchDaryHeap<16>(heapInput, counters, allocs);
+			std::cout << std::endl;
+		}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Concurrent PQ, n preloaded, then 2n alternating insert / removeMin
+		*		split over 1..N threads
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    CONCURRENT PQ, " + std::to_string(2 * SAMPLES) + " operations    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		for (unsigned t : threadCounts) {
+			int opsPerThread = 2 * SAMPLES / static_cast<int>(t);
+			// one lock around the whole heap
+			{
+				HeapPriorityQueue<int, Compare<int>> heap(input.begin(), input.end());
+				std::mutex lock;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				runThreads(t, [&](unsigned id) {
+					for (int i = 0; i < opsPerThread; i++) {
+						std::lock_guard<std::mutex> guard(lock);
+						if (i % 2 == 0)
+							heap.insert(input[(id + static_cast<size_t>(i) * t) % SAMPLES]);
+						else if (!heap.empty())
+							heap.removeMin();
+					}
+				});
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Global Mutex Vector Heap, " + std::to_string(t) + " threads", stop - start, counters, allocs, 2 * SAMPLES);
+			}
+			// the same run logged, removals replayed for their rank; the tickets
+			// are taken outside the shard locks, so this is an upper bound
+			// (more so when threads outnumber cores and get preempted)
+			double rankError = 0;
+			{
+				MultiQueue<int> mq(t);
+				std::atomic<uint64_t> ticket(0);
+				std::vector<std::vector<QueueEvent>> logs(t);
+				std::vector<QueueEvent> events;
+				for (int x : input) {
+					mq.insert(x);
+					events.push_back(QueueEvent{ ticket++, x, false });
+				}
+				runThreads(t, [&](unsigned id) {
+					std::vector<QueueEvent>& log = logs[id];
+					int x;
+					for (int i = 0; i < opsPerThread; i++) {
+						if (i % 2 == 0) { // ticket before an insert, after a removal
+							x = input[(id + static_cast<size_t>(i) * t) % SAMPLES];
+							log.push_back(QueueEvent{ ticket++, x, false });
+							mq.insert(x);
+						}
+						else if (mq.tryRemoveMin(x))
+							log.push_back(QueueEvent{ ticket++, x, true });
+					}
+				});
+				for (auto& log : logs)
+					events.insert(events.end(), log.begin(), log.end());
+				rankError = meanRankError(events);
+			}
+			{
+				MultiQueue<int> mq(t);
+				for (int x : input)
+					mq.insert(x);
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				runThreads(t, [&](unsigned id) {
+					int x;
+					for (int i = 0; i < opsPerThread; i++) {
+						if (i % 2 == 0)
+							mq.insert(input[(id + static_cast<size_t>(i) * t) % SAMPLES]);
+						else
+							mq.tryRemoveMin(x);
+					}
+				});
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				std::ostringstream label;
+				label << "MultiQueue, " << t << " threads (rank error " << std::fixed << std::setprecision(1) << rankError << ")";
+				printResult(label.str(), stop - start, counters, allocs, 2 * SAMPLES);
+			}
+			// inserts only, every element once
+			{
+				HeapPriorityQueue<int, Compare<int>> heap;
+				std::mutex lock;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				runThreads(t, [&](unsigned id) {
+					for (size_t i = id; i < input.size(); i += t) {
+						std::lock_guard<std::mutex> guard(lock);
+						heap.insert(input[i]);
+					}
+				});
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Global Mutex Vector Heap, n inserts, " + std::to_string(t) + " threads", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				SkipListPriorityQueue<int> skip;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				runThreads(t, [&](unsigned id) {
+					for (size_t i = id; i < input.size(); i += t)
+						skip.concurrentInsert(input[i]);
+				});
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Lock-free Skip List, n inserts, " + std::to_string(t) + " threads", stop - start, counters, allocs, SAMPLES);
+				if (skip.size() != SAMPLES || !std::is_sorted(skip.begin(), skip.end()))
+					std::cerr << "skip list lost an insert" << std::endl;
+			}
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Work queue throughput, half the threads produce the n elements
+		*		and half consume them, 1 to 64 threads whatever the core count
+		*  ------------------------------------------------------------------------------
+		*/
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    MPMC WORK QUEUE    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		{
+			long long expected = 0;
+			for (int x : input)
+				expected += x;
+			for (unsigned t = 1; t <= 64; t *= 2) {
+				{
+					LinkedList<int> list;
+					std::mutex lock;
+					allocs.start();
+					auto start = std::chrono::high_resolution_clock::now();
+					counters.start();
+					long long sum = runProducersConsumers(t, input,
+						[&](int x) {
+							std::lock_guard<std::mutex> guard(lock);
+							list.insertBack(x);
+						},
+						[&](int& x) {
+							std::lock_guard<std::mutex> guard(lock);
+							if (list.empty())
+								return false;
+							x = list.removeFront();
+							return true;
+						});
+					counters.stop();
+					allocs.stop();
+					auto stop = std::chrono::high_resolution_clock::now();
+					printResult("Mutex LinkedList, " + std::to_string(t) + " threads", stop - start, counters, allocs, SAMPLES);
+					if (sum != expected)
+						std::cerr << "mutex queue lost an element" << std::endl;
+				}
+				{
+					ConcurrentQueue<int> queue;
+					allocs.start();
+					auto start = std::chrono::high_resolution_clock::now();
+					counters.start();
+					long long sum = runProducersConsumers(t, input,
+						[&](int x) { queue.insertBack(x); },
+						[&](int& x) { return queue.tryRemoveFront(x); });
+					counters.stop();
+					allocs.stop();
+					auto stop = std::chrono::high_resolution_clock::now();
+					printResult("Lock-free MPMC Queue, " + std::to_string(t) + " threads", stop - start, counters, allocs, SAMPLES);
+					if (sum != expected)
+						std::cerr << "lock-free queue lost an element" << std::endl;
+				}
+			}
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Shard Merge, n elements spread over s queues combined into one
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		for (int shards : { 16, 256 }) {
+			if (shards > SAMPLES)
+				break;
+			printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    SHARD MERGE, " + std::to_string(shards) + " shards    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+			// drain every shard and reinsert into the first
+			{
+				std::vector<HeapPriorityQueue<int, Compare<int>>> heaps(shards);
+				for (int i = 0; i < SAMPLES; i++)
+					heaps[i % shards].insert(input[i]);
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int sh = 1; sh < shards; sh++)
+					while (!heaps[sh].empty()) {
+						heaps[0].insert(heaps[sh].min());
+						heaps[sh].removeMin();
+					}
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Vector Min Heap, drain + reinsert", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				std::vector<std::unique_ptr<PairingHeap<int>>> heaps;
+				for (int sh = 0; sh < shards; sh++)
+					heaps.emplace_back(new PairingHeap<int>);
+				for (int i = 0; i < SAMPLES; i++)
+					heaps[i % shards]->insert(input[i]);
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int sh = 1; sh < shards; sh++)
+					heaps[0]->meld(*heaps[sh]);
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Pairing Heap, meld()", stop - start, counters, allocs, SAMPLES);
+			}
+			std::cout << std::endl;
+		}
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Double-Ended Queue, a bounded scheduler : every arrival is queued,
+		*		every second step dispatches the cheapest, and past n / 10 pending
+		*		the most expensive is dropped; then the rest drains from both ends
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    MIN-MAX, bounded scheduler    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		{
+			int bound = SAMPLES / 10 > 0 ? SAMPLES / 10 : 1;
+			{
+				MinMaxHeap<int> jobs;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int i = 0; i < SAMPLES; i++) {
+					jobs.insert(input[i]);
+					if (i % 2 == 1)
+						jobs.removeMin();
+					if (jobs.size() > bound)
+						jobs.removeMax();
+				}
+				for (int i = 0; !jobs.empty(); i++)
+					if (i % 2)
+						jobs.removeMax();
+					else
+						jobs.removeMin();
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Min-Max Heap", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				// (priority, job id) in both heaps, a job removed from one is
+				// marked and skipped when it surfaces in the other
+				typedef std::pair<int, int> Job;
+				HeapPriorityQueue<Job, Compare<Job>> cheapest;
+				HeapPriorityQueue<Job, Greater<Job>> dearest;
+				std::vector<char> removed(SAMPLES, 0);
+				int pending = 0;
+				auto dropStale = [&]() {
+					while (!cheapest.empty() && removed[cheapest.min().second])
+						cheapest.removeMin();
+					while (!dearest.empty() && removed[dearest.min().second])
+						dearest.removeMin();
+				};
+				auto popCheapest = [&]() {
+					dropStale();
+					removed[cheapest.min().second] = 1;
+					cheapest.removeMin();
+					pending--;
+				};
+				auto popDearest = [&]() {
+					dropStale();
+					removed[dearest.min().second] = 1;
+					dearest.removeMin();
+					pending--;
+				};
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (int i = 0; i < SAMPLES; i++) {
+					cheapest.insert(Job(input[i], i));
+					dearest.insert(Job(input[i], i));
+					pending++;
+					if (i % 2 == 1)
+						popCheapest();
+					if (pending > bound)
+						popDearest();
+				}
+				for (int i = 0; pending > 0; i++)
+					if (i % 2)
+						popDearest();
+					else
+						popCheapest();
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Two Vector Heaps, lazy cross-deletion", stop - start, counters, allocs, SAMPLES);
+			}
+			// O(n) construction against n inserts
+			{
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				MinMaxHeap<int> built(input.begin(), input.end());
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Min-Max Heap, build from n", stop - start, counters, allocs, SAMPLES);
+			}
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		LinkedList Node Churn, per node allocator policy
+		*  ------------------------------------------------------------------------------
+		*/
+		generateDistribution(dist, input, SAMPLES, params);
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    LINKED LIST NODE CHURN    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		benchListChurn<NewNodeAllocator<int>>(input, "new / delete", counters, allocs);
+		benchListChurn<PooledNodeAllocator<int>>(input, "Pooled", counters, allocs);
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Unrolled Linked List vs LinkedList, inserts and linear scans
+		*  ------------------------------------------------------------------------------
+		*/
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    UNROLLED LINKED LIST    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		benchListOps<LinkedList<int>>(input, "LinkedList", counters, allocs);
+		benchListOps<UnrolledLinkedList<int>>(input, "Unrolled List", counters, allocs);
+		{
+			PriorityQueue<int> pq; // findMin() walks the LinkedList node by node
+			UnrolledLinkedList<int> unrolled;
+			for (int i = 0; i < SAMPLES; i++) {
+				pq.insert(input[i]);
+				unrolled.insertFront(input[i]);
+			}
+			int listMin = 0, unrolledMin = 0;
 
-	// print sorted results
-	//std::cout << "bubble sort: " << std::endl;
-	//for (auto i : sorted) {
-	//	std::cout << i << std::endl;
-	// }
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			for (int scan = 0; scan < 16; scan++)
+				listMin = pq.min();
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("LinkedList, 16 min scans (PQ findMin)", stop - start, counters, allocs, SAMPLES);
+
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			for (int scan = 0; scan < 16; scan++) {
+				auto m = unrolled.minElement(Compare<int>());
+				unrolledMin = m.block->data[m.index];
+			}
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("Unrolled List, 16 min scans (minElement)", stop - start, counters, allocs, SAMPLES);
+
+			if (listMin != unrolledMin)
+				std::cerr << "list min scans differ" << std::endl;
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		Intrusive List vs LinkedList on records that already live in an
+		*		arena, LinkedList copies each one into a node of its own
+		*  ------------------------------------------------------------------------------
+		*/
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    INTRUSIVE LIST, " + std::to_string(sizeof(ArenaRecord)) + " byte records    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		{
+			std::vector<ArenaRecord> arena(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				arena[i].key = input[i];
+
+			{
+				LinkedList<ArenaRecord> owning;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (ArenaRecord& r : arena)
+					owning.insertBack(r);
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("LinkedList, n insertBack (copies)", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				IntrusiveList<ArenaRecord> intrusive;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (ArenaRecord& r : arena)
+					intrusive.insertBack(r);
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("IntrusiveList, n insertBack", stop - start, counters, allocs, SAMPLES);
+
+				allocs.start();
+				start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (size_t i = 0; i < arena.size(); i += 2)
+					intrusive.erase(arena[i]); // by reference, no search
+				counters.stop();
+				allocs.stop();
+				stop = std::chrono::high_resolution_clock::now();
+				printResult("IntrusiveList, erase every other record", stop - start, counters, allocs, SAMPLES / 2);
+			}
+
+			int owningMin = 0, intrusiveMin = 0;
+			{
+				PriorityQueue<ArenaRecord> pq;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (ArenaRecord& r : arena)
+					pq.insert(r);
+				for (int scan = 0; scan < 16; scan++)
+					owningMin = pq.min().key;
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("LL PQ, n inserts + 16 min scans", stop - start, counters, allocs, SAMPLES);
+			}
+			{
+				PriorityQueue<ArenaRecord, IntrusiveNodes<>> pq;
+				allocs.start();
+				auto start = std::chrono::high_resolution_clock::now();
+				counters.start();
+				for (ArenaRecord& r : arena)
+					pq.insert(r);
+				for (int scan = 0; scan < 16; scan++)
+					intrusiveMin = pq.min().key;
+				counters.stop();
+				allocs.stop();
+				auto stop = std::chrono::high_resolution_clock::now();
+				printResult("Intrusive PQ, n inserts + 16 min scans", stop - start, counters, allocs, SAMPLES);
+			}
+			if (owningMin != intrusiveMin)
+				std::cerr << "intrusive PQ min differs" << std::endl;
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		LinkedList duplicate removal and set operations, every value about
+		*		four times; the O(n^2) scan only gets the first 16384 elements
+		*  ------------------------------------------------------------------------------
+		*/
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    LINKED LIST DEDUPE AND SET OPERATIONS    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		{
+			int distinct = SAMPLES / 4 > 0 ? SAMPLES / 4 : 1;
+			std::vector<int> keys(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				keys[i] = static_cast<int>(static_cast<unsigned>(input[i]) % distinct);
+			int scanned = SAMPLES < 16384 ? SAMPLES : 16384;
+			int scanLeft = 0, hashedLeft = 0;
+
+			LinkedList<int> list;
+			for (int i = 0; i < scanned; i++)
+				list.insertBack(keys[i]);
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			list.removeDup();
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			scanLeft = list.size();
+			printResult("removeDup() O(n^2) scan, " + std::to_string(scanned) + " elements", stop - start, counters, allocs, scanned);
+
+			LinkedList<int> prefix;
+			for (int i = 0; i < scanned; i++)
+				prefix.insertBack(keys[i]);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			prefix.removeDupHashed();
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			hashedLeft = prefix.size();
+			printResult("removeDupHashed(), " + std::to_string(scanned) + " elements", stop - start, counters, allocs, scanned);
+			if (scanLeft != hashedLeft)
+				std::cerr << "removeDup modes disagree" << std::endl;
+
+			LinkedList<int> all;
+			for (int k : keys)
+				all.insertBack(k);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			all.removeDupHashed();
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("removeDupHashed()", stop - start, counters, allocs, SAMPLES);
+
+			std::vector<int> sortedKeys(keys);
+			std::sort(sortedKeys.begin(), sortedKeys.end());
+			LinkedList<int> ordered;
+			for (int k : sortedKeys)
+				ordered.insertBack(k);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			ordered.removeDupSorted();
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("removeDupSorted(), sorted input", stop - start, counters, allocs, SAMPLES);
+
+			// the two halves of the keys as sets
+			LinkedList<int> left, right;
+			for (size_t i = 0; i < keys.size(); i++)
+				(i < keys.size() / 2 ? left : right).insertBack(keys[i]);
+			LinkedList<int> unionList(left), intersectList(left), differenceList(left);
+
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			unionList.unionWith(right);
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("unionWith()", stop - start, counters, allocs, SAMPLES);
+
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			intersectList.intersectWith(right);
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("intersectWith()", stop - start, counters, allocs, SAMPLES);
+
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			differenceList.differenceWith(right);
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("differenceWith()", stop - start, counters, allocs, SAMPLES);
+		}
+		std::cout << std::endl;
+
+		/*
+		* -------------------------------------------------------------------------------
+		*		LinkedList sort, merge and splice by relinking nodes, against
+		*		copying the payloads
+		*  ------------------------------------------------------------------------------
+		*/
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + "    LINKED LIST SORT, MERGE AND SPLICE    DISTRIBUTION: " + distributionName(dist), counters, allocs);
+		{
+			LinkedList<int> list;
+			for (int x : input)
+				list.insertBack(x);
+			allocs.start();
+			auto start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			list.sort();
+			counters.stop();
+			allocs.stop();
+			auto stop = std::chrono::high_resolution_clock::now();
+			printResult("sort(), bottom-up merge in place", stop - start, counters, allocs, SAMPLES);
+
+			LinkedList<int> copied;
+			for (int x : input)
+				copied.insertBack(x);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			{
+				std::vector<int> buffer;
+				buffer.reserve(SAMPLES);
+				while (!copied.empty())
+					buffer.push_back(copied.removeFront());
+				std::sort(buffer.begin(), buffer.end());
+				for (int x : buffer)
+					copied.insertBack(x);
+			}
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("copy to vector, std::sort, copy back", stop - start, counters, allocs, SAMPLES);
+
+			// two sorted halves
+			std::vector<int> low(input.begin(), input.begin() + SAMPLES / 2), high(input.begin() + SAMPLES / 2, input.end());
+			std::sort(low.begin(), low.end());
+			std::sort(high.begin(), high.end());
+			LinkedList<int> a, b;
+			for (int x : low)
+				a.insertBack(x);
+			for (int x : high)
+				b.insertBack(x);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			a.mergeSorted(b);
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("mergeSorted(), two sorted halves", stop - start, counters, allocs, SAMPLES);
+
+			LinkedList<int> c, d;
+			for (int x : low)
+				c.insertBack(x);
+			for (int x : high)
+				d.insertBack(x);
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			{
+				LinkedList<int> merged; // std::merge style, one copy per element
+				while (!c.empty() && !d.empty())
+					merged.insertBack(d.getHead() < c.getHead() ? d.removeFront() : c.removeFront());
+				while (!c.empty())
+					merged.insertBack(c.removeFront());
+				while (!d.empty())
+					merged.insertBack(d.removeFront());
+				c = std::move(merged);
+			}
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("copying merge, two sorted halves", stop - start, counters, allocs, SAMPLES);
+			if (a.size() != c.size() || a.getTail() != c.getTail())
+				std::cerr << "list merges differ" << std::endl;
+
+			// 64 shard lists gathered into one
+			const int SHARDS = 64;
+			std::vector<LinkedList<int>> shards(SHARDS), copies(SHARDS);
+			std::vector<LinkedList<int, PooledNodeAllocator<int>>> pooled(SHARDS);
+			for (int i = 0; i < SAMPLES; i++) {
+				shards[i % SHARDS].insertBack(input[i]);
+				copies[i % SHARDS].insertBack(input[i]);
+				pooled[i % SHARDS].insertBack(input[i]);
+			}
+			LinkedList<int> gathered;
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			for (auto& shard : shards)
+				gathered.splice(shard);
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("splice(), 64 shards", stop - start, counters, allocs, SAMPLES);
+
+			LinkedList<int, PooledNodeAllocator<int>> gatheredPool;
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			for (auto& shard : pooled)
+				gatheredPool.splice(shard); // takes over each shard's pool
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("splice(), 64 pooled shards", stop - start, counters, allocs, SAMPLES);
+
+			LinkedList<int> gatheredCopy;
+			allocs.start();
+			start = std::chrono::high_resolution_clock::now();
+			counters.start();
+			for (auto& shard : copies)
+				while (!shard.empty())
+					gatheredCopy.insertBack(shard.removeFront());
+			counters.stop();
+			allocs.stop();
+			stop = std::chrono::high_resolution_clock::now();
+			printResult("copy node by node, 64 shards", stop - start, counters, allocs, SAMPLES);
+		}
+		std::cout << std::endl;
+	}
 
 	/*
 	* -------------------------------------------------------------------------------
-	*		STL Quick Sort on std::vector
+	*		Dijkstra on a random graph, n vertices and 8n weighted edges
 	*  ------------------------------------------------------------------------------
 	*/
-	sorted.clear();
-
-	// insert elements in vector
-	for (int i = 0; i < SAMPLES; i++)
-		sorted.push_back(std::rand() % 1000 + 1);
-	// sort
-	start = std::chrono::high_resolution_clock::now();
-	std::sort(sorted.begin(), sorted.end());
-	stop = std::chrono::high_resolution_clock::now();
+	{
+		std::vector<int> offsets, targets, weights;
+		randomGraph(SAMPLES, 8, params.seed, offsets, targets, weights);
+		int edges = static_cast<int>(targets.size());
+		printHeader("SAMPLE SIZE: " + std::to_string(SAMPLES) + " vertices, " + std::to_string(edges) + " edges    DIJKSTRA", counters, allocs);
+		std::vector<long long> addressableDist, lazyDist;
+		int peak = 0;
 
-	// print runtime results
-	std::cout << std::setw(50) << std::left << "STL Quick Sort on std::vector<int> "
-		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
-		<< std::chrono::duration_cast <std::chrono::microseconds>
-		(stop - start).count() / 1000. << " milliseconds\n";
-	std::cout << "------------------------------------------------------------------------" << std::endl;
+		// one heap entry per vertex, relaxations call decreaseKey()
+		allocs.start();
+		auto start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		dijkstraAddressable(offsets, targets, weights, addressableDist, peak);
+		counters.stop();
+		allocs.stop();
+		auto stop = std::chrono::high_resolution_clock::now();
+		printResult("Addressable 4-ary Heap, peak " + std::to_string(peak), stop - start, counters, allocs, edges);
 
+		// every relaxation pushes, stale entries are skipped when popped
+		allocs.start();
+		start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		dijkstraLazy(offsets, targets, weights, lazyDist, peak);
+		counters.stop();
+		allocs.stop();
+		stop = std::chrono::high_resolution_clock::now();
+		printResult("Lazy Deletion Vector Heap, peak " + std::to_string(peak), stop - start, counters, allocs, edges);
+		if (addressableDist != lazyDist)
+			std::cerr << "Dijkstra distances differ" << std::endl;
+		std::cout << std::endl;
+	}
 
-	// print sorted results
-	//std::cout << "STL quick_sort : " << std::endl;
-	//int sz = sorted.size();
-	//for (int i = 0; i < sz; i++) {
-	//	std::cout << i << " " << sorted[i] << std::endl;
-	//}
 
 	std::cout << "\nPress any key to continue " << std::endl;
 	char end_of_tests; std::cin >> end_of_tests;
@@ -261,6 +1576,7 @@ int main()
 }
 
 
+
 // Utility function to find minimum of two integers
 int min(int x, int y) { return (x < y) ? x : y; }
 
@@ -300,18 +1616,9 @@ void merge(std::vector<int>& sorted, int* L, int* R, int l, int m, int r)
 	int n1 = m - l + 1;
 	int n2 = r - m;
 
-	static int x = 0;
 	/* create temp arrays */
-	if (x++ == 0) {
-		L = new int[n1];
-		R = new int[n2]; // memory leak, need to delete these somewhere
-	}
-	else {
-		delete [] L;
-		delete [] R;
-		L = new int[n1];
-		R = new int[n2];
-	}
+	L = new int[n1];
+	R = new int[n2];
 
 	/* Copy data to temp arrays L[] and R[] */
 	for (i = 0; i < n1; i++)
@@ -353,6 +1660,9 @@ void merge(std::vector<int>& sorted, int* L, int* R, int l, int m, int r)
 		j++;
 		k++;
 	}
+
+	delete[] L;
+	delete[] R;
 }
 
 void swap(int* x, int* y) {
@@ -371,3 +1681,358 @@ void bubbleSort(std::vector<int>& sorted) {
 		}
 	}
 }
+
+/* Merge runs [bounds[r], bounds[r+1]) pairwise with merge() until one run is left */
+void pairwiseMerge(std::vector<int>& sorted, std::vector<int> bounds)
+{
+	int* L = nullptr;
+	int* R = nullptr;
+	while (bounds.size() > 2) {
+		std::vector<int> next;
+		size_t r = 0;
+		for (; r + 2 < bounds.size(); r += 2) {
+			merge(sorted, L, R, bounds[r], bounds[r + 1] - 1, bounds[r + 2] - 1);
+			next.push_back(bounds[r]);
+		}
+		if (r + 1 < bounds.size()) // odd run out, carried to the next pass
+			next.push_back(bounds[r]);
+		next.push_back(bounds.back());
+		bounds.swap(next);
+	}
+}
+
+/* Replay the events in ticket order, a removal's rank is the number of
+   smaller elements present at that point (0 for an exact priority queue) */
+double meanRankError(std::vector<QueueEvent>& events)
+{
+	std::sort(events.begin(), events.end(),
+		[](const QueueEvent& a, const QueueEvent& b) { return a.ticket < b.ticket; });
+	std::vector<int> keys;
+	for (auto& e : events)
+		keys.push_back(e.value);
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	std::vector<long long> tree(keys.size() + 1, 0); // Fenwick tree of present keys
+	double ranks = 0;
+	long long removals = 0;
+	for (auto& e : events) {
+		size_t k = std::lower_bound(keys.begin(), keys.end(), e.value) - keys.begin() + 1;
+		if (e.removal) {
+			for (size_t i = k - 1; i > 0; i -= i & (0 - i)) // present keys below e.value
+				ranks += tree[i];
+			removals++;
+		}
+		for (size_t i = k; i < tree.size(); i += i & (0 - i))
+			tree[i] += e.removal ? -1 : 1;
+	}
+	return removals > 0 ? ranks / removals : 0;
+}
+
+/* body(0) ... body(threads - 1), each on its own thread */
+template <class F>
+void runThreads(unsigned threads, const F& body)
+{
+	std::vector<std::thread> workers;
+	for (unsigned id = 0; id < threads; id++)
+		workers.emplace_back([&body, id]() { body(id); });
+	for (auto& w : workers)
+		w.join();
+}
+
+/* Producers [0, threads / 2) push input between them, the other threads
+   pop until every element is out; one thread alternates push and pop.
+   Returns the sum of the popped elements. */
+template <class Push, class Pop>
+long long runProducersConsumers(unsigned threads, const std::vector<int>& input, const Push& push, const Pop& pop)
+{
+	size_t n = input.size();
+	std::atomic<long long> sum(0);
+	if (threads == 1) {
+		int x;
+		long long local = 0;
+		for (size_t i = 0; i < n; i++) {
+			push(input[i]);
+			if (pop(x))
+				local += x;
+		}
+		return local;
+	}
+	unsigned producers = threads / 2;
+	std::atomic<size_t> popped(0);
+	runThreads(threads, [&](unsigned id) {
+		if (id < producers) {
+			for (size_t i = id; i < n; i += producers)
+				push(input[i]);
+			return;
+		}
+		long long local = 0;
+		int x;
+		while (popped.load(std::memory_order_relaxed) < n) {
+			if (pop(x)) {
+				local += x;
+				popped.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+				std::this_thread::yield(); // let a producer in when threads outnumber cores
+		}
+		sum += local;
+	});
+	return sum;
+}
+
+/* Directed graph in compressed rows, the edges of v are [offsets[v], offsets[v+1]) */
+void randomGraph(int vertices, int degree, uint64_t seed,
+	std::vector<int>& offsets, std::vector<int>& targets, std::vector<int>& weights)
+{
+	offsets.assign(vertices + 1, 0);
+	targets.clear();
+	weights.clear();
+	for (int v = 0; v < vertices; v++) {
+		offsets[v] = static_cast<int>(targets.size());
+		for (int e = 0; e < degree; e++) {
+			uint64_t r = dist_detail::hash(seed, static_cast<uint64_t>(v) * degree + e);
+			targets.push_back(static_cast<int>(r % vertices));
+			weights.push_back(1 + static_cast<int>((r >> 32) % 1000));
+		}
+	}
+	offsets[vertices] = static_cast<int>(targets.size());
+}
+
+/* Shortest distances from vertex 0, -1 where unreachable */
+void dijkstraAddressable(const std::vector<int>& offsets, const std::vector<int>& targets,
+	const std::vector<int>& weights, std::vector<long long>& dist, int& peak)
+{
+	typedef std::pair<long long, int> Label; // (distance, vertex)
+	int vertices = static_cast<int>(offsets.size()) - 1;
+	dist.assign(vertices, -1);
+	std::vector<AddressableHeap<Label>::Handle> handle(vertices, -1);
+	AddressableHeap<Label> heap;
+	peak = 0;
+	if (vertices == 0)
+		return;
+	handle[0] = heap.insert(Label(0, 0));
+	while (!heap.empty()) {
+		Label u = heap.min();
+		heap.removeMin();
+		dist[u.second] = u.first;
+		for (int e = offsets[u.second]; e < offsets[u.second + 1]; e++) {
+			int v = targets[e];
+			long long d = u.first + weights[e];
+			if (dist[v] >= 0)
+				continue; // already settled
+			if (handle[v] < 0) // unsettled vertices keep their handle
+				handle[v] = heap.insert(Label(d, v));
+			else if (d < heap.key(handle[v]).first)
+				heap.decreaseKey(handle[v], Label(d, v));
+		}
+		peak = heap.size() > peak ? heap.size() : peak;
+	}
+}
+
+void dijkstraLazy(const std::vector<int>& offsets, const std::vector<int>& targets,
+	const std::vector<int>& weights, std::vector<long long>& dist, int& peak)
+{
+	typedef std::pair<long long, int> Label; // (distance, vertex)
+	int vertices = static_cast<int>(offsets.size()) - 1;
+	dist.assign(vertices, -1);
+	std::vector<long long> best(vertices, -1); // shortest distance pushed so far
+	HeapPriorityQueue<Label, Compare<Label>> heap;
+	peak = 0;
+	if (vertices == 0)
+		return;
+	heap.insert(Label(0, 0));
+	best[0] = 0;
+	while (!heap.empty()) {
+		Label u = heap.min();
+		heap.removeMin();
+		if (dist[u.second] >= 0)
+			continue; // stale entry
+		dist[u.second] = u.first;
+		for (int e = offsets[u.second]; e < offsets[u.second + 1]; e++) {
+			int v = targets[e];
+			long long d = u.first + weights[e];
+			if (dist[v] < 0 && (best[v] < 0 || d < best[v])) {
+				best[v] = d;
+				heap.insert(Label(d, v));
+			}
+		}
+		peak = heap.size() > peak ? heap.size() : peak;
+	}
+}
+
+int ruleWidth(const PerfCounters& counters, const AllocCounters& allocs) {
+	return 73 + (counters.available() ? 10 * NUM_PERF_EVENTS : 0) + (allocs.available() ? 48 : 0);
+}
+
+void printHeader(const std::string& title, const PerfCounters& counters, const AllocCounters& allocs) {
+	std::string rule(ruleWidth(counters, allocs), '*');
+	std::cout << rule << std::endl;
+	std::cout << title << std::endl;
+	std::cout << std::setw(50) << std::left << "DATA STRUCTURE"
+		<< std::setw(23) << std::right << "RUNTIME"; // over the value and " milliseconds"
+	if (counters.available())
+		for (int e = 0; e < NUM_PERF_EVENTS; e++)
+			std::cout << std::setw(10) << std::right << PerfCounters::name(static_cast<PerfEvent>(e));
+	if (allocs.available())
+		std::cout << std::setw(12) << std::right << "ALLOCS" << std::setw(12) << "BYTES"
+			<< std::setw(12) << "PEAK" << std::setw(12) << "PEAK B/EL";
+	std::cout << std::endl;
+	std::cout << rule << std::endl;
+}
+
+template <int D>
+void benchDaryHeap(const std::vector<int>& input, PerfCounters& counters, AllocCounters& allocs) {
+	int n = static_cast<int>(input.size());
+	HeapPriorityQueue<int, Compare<int>, D> heap;
+	std::string label = std::to_string(D) + "-ary Min Heap, ";
+#ifdef HEAP_SIMD_SSE41
+	if (D % 4 == 0) // ChildMin's vector scan (VectorCompleteTree.hpp)
+		label = std::to_string(D) + "-ary Min Heap SSE4.1, ";
+#endif
+
+	allocs.start();
+	auto start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	for (int i = 0; i < n; i++)
+		heap.insert(input[i]);
+	counters.stop();
+	allocs.stop();
+	auto stop = std::chrono::high_resolution_clock::now();
+	printResult(label + "n inserts", stop - start, counters, allocs, n);
+
+	allocs.start();
+	start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	HeapPriorityQueue<int, Compare<int>, D> built(input.begin(), input.end());
+	counters.stop();
+	allocs.stop();
+	stop = std::chrono::high_resolution_clock::now();
+	printResult(label + "heapify n", stop - start, counters, allocs, n);
+
+	allocs.start();
+	start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	while (!heap.empty())
+		heap.removeMin();
+	counters.stop();
+	allocs.stop();
+	stop = std::chrono::high_resolution_clock::now();
+	printResult(label + "n removeMin()", stop - start, counters, allocs, n);
+}
+
+template <class Alloc>
+void benchListChurn(const std::vector<int>& input, const std::string& name, PerfCounters& counters, AllocCounters& allocs) {
+	int n = static_cast<int>(input.size());
+
+	// a FIFO of at most 1024 jobs, every arrival past that retires the oldest
+	{
+		LinkedList<int, Alloc> fifo;
+		allocs.start();
+		auto start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		for (int i = 0; i < n; i++) {
+			fifo.insertBack(input[i]);
+			if (fifo.size() > 1024)
+				fifo.removeFront();
+		}
+		counters.stop();
+		allocs.stop();
+		auto stop = std::chrono::high_resolution_clock::now();
+		printResult(name + " nodes, FIFO churn", stop - start, counters, allocs, n);
+	}
+	// n nodes in, one clear()
+	{
+		LinkedList<int, Alloc> list;
+		allocs.start();
+		auto start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		for (int i = 0; i < n; i++)
+			list.insertBack(input[i]);
+		if (!list.empty()) // clear() throws on an empty list
+			list.clear();
+		counters.stop();
+		allocs.stop();
+		auto stop = std::chrono::high_resolution_clock::now();
+		printResult(name + " nodes, n insertBack + clear()", stop - start, counters, allocs, n);
+	}
+	// 16 full findMin() scans over n nodes, traversal locality
+	{
+		PriorityQueue<int, Alloc> pq;
+		for (int i = 0; i < n; i++)
+			pq.insert(input[i]);
+		int first = pq.min(), found = first;
+		allocs.start();
+		auto start = std::chrono::high_resolution_clock::now();
+		counters.start();
+		for (int scan = 0; scan < 16; scan++)
+			found = std::min(found, pq.min());
+		counters.stop();
+		allocs.stop();
+		auto stop = std::chrono::high_resolution_clock::now();
+		printResult(name + " nodes, 16 PQ min() scans", stop - start, counters, allocs, n);
+		if (found != first)
+			std::cerr << "PQ min() scans differ" << std::endl;
+	}
+}
+
+template <class List>
+void benchListOps(const std::vector<int>& input, const std::string& name, PerfCounters& counters, AllocCounters& allocs) {
+	int n = static_cast<int>(input.size());
+	List list;
+
+	allocs.start();
+	auto start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	for (int i = 0; i < n; i++)
+		list.insertBack(input[i]);
+	counters.stop();
+	allocs.stop();
+	auto stop = std::chrono::high_resolution_clock::now();
+	printResult(name + ", n insertBack", stop - start, counters, allocs, n);
+
+	allocs.start();
+	start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	for (int i = 0; i < n; i++)
+		list.insertFront(input[i]);
+	counters.stop();
+	allocs.stop();
+	stop = std::chrono::high_resolution_clock::now();
+	printResult(name + ", n insertFront", stop - start, counters, allocs, n);
+
+	allocs.start();
+	start = std::chrono::high_resolution_clock::now();
+	counters.start();
+	while (!list.empty())
+		list.removeFront();
+	counters.stop();
+	allocs.stop();
+	stop = std::chrono::high_resolution_clock::now();
+	printResult(name + ", 2n removeFront", stop - start, counters, allocs, n);
+}
+
+void printResult(const std::string& label, std::chrono::high_resolution_clock::duration elapsed,
+	const PerfCounters& counters, const AllocCounters& allocs, int n) {
+	std::cout << std::setw(50) << std::left << label
+		<< std::setw(10) << std::right << std::fixed << std::setprecision(2)
+		<< std::chrono::duration_cast <std::chrono::microseconds>
+		(elapsed).count() / 1000. << " milliseconds";
+	// counters per element, n/a where the event could not be opened
+	if (counters.available()) {
+		for (int e = 0; e < NUM_PERF_EVENTS; e++) {
+			PerfEvent ev = static_cast<PerfEvent>(e);
+			if (counters.available(ev) && n > 0)
+				std::cout << std::setw(10) << std::right << std::setprecision(2)
+					<< static_cast<double>(counters.value(ev)) / n;
+			else
+				std::cout << std::setw(10) << std::right << "n/a";
+		}
+	}
+	// allocations made while building and running the structure
+	if (allocs.available())
+		std::cout << std::setw(12) << std::right << allocs.allocations() << std::setw(12) << allocs.bytes()
+			<< std::setw(12) << allocs.peak() << std::setw(12) << std::setprecision(2)
+			<< (n > 0 ? static_cast<double>(allocs.peak()) / n : 0.);
+	std::cout << "\n";
+	std::cout << std::string(ruleWidth(counters, allocs), '-') << std::endl;
+}
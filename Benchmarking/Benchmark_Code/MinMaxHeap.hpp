@@ -0,0 +1,178 @@
+#pragma once
+/**
+	Description :
+	Min-Max Heap (double-ended priority queue) on VectorCompleteTree
+
+	Atkinson et al. : nodes on even depths (the root's) are no greater
+	than anything below them, nodes on odd depths no smaller. The
+	minimum is the root and the maximum one of its two children, both
+	O(1). insert() bubbles up along the min or the max levels, every
+	second ancestor; removeMin() and removeMax() refill the hole with
+	the last element and trickle it down two levels at a time, comparing
+	against children and grandchildren. O(log n) each, and the range
+	constructor builds in O(n) by trickling down every internal node,
+	last one first.
+**/
+
+#include <utility> // std::move
+
+#include "VectorCompleteTree.hpp"
+
+template <class NodeType, class C = Compare<NodeType>>
+class MinMaxHeap
+{
+public:
+	MinMaxHeap() {}
+	template <class InputIt>
+	MinMaxHeap(InputIt first, InputIt last);
+	int size() const { return T.size(); }
+	bool empty() const { return size() == 0; }
+	void insert(const NodeType& e);
+	const NodeType& min() { return *T.root(); }
+	const NodeType& max() { return *maxPosition(); }
+	void removeMin() { removeAt(T.root()); }
+	void removeMax() { removeAt(maxPosition()); }
+private:
+	typedef typename VectorCompleteTree<NodeType>::Position Position;
+
+	bool onMinLevel(const Position& p) const { return T.depth(p) % 2 == 0; }
+	Position maxPosition();
+	void removeAt(Position p);
+	void bubbleUp(Position p);
+	// Max selects the max levels, isLess is then read reversed
+	template <bool Max>
+	void bubbleUpLevels(Position p);
+	template <bool Max>
+	void trickleDown(Position p);
+	template <bool Max>
+	bool before(const NodeType& x, const NodeType& y) { return Max ? isLess(y, x) : isLess(x, y); }
+
+	VectorCompleteTree<NodeType> T;
+	C isLess;
+};
+
+template <class NodeType, class C>
+template <class InputIt>
+MinMaxHeap<NodeType, C>::MinMaxHeap(InputIt first, InputIt last)
+{
+	for (; first != last; ++first)
+		T.addLast(*first);
+	if (size() < 2)
+		return;
+	for (Position p = T.parent(T.last());; --p) {
+		if (onMinLevel(p))
+			trickleDown<false>(p);
+		else
+			trickleDown<true>(p);
+		if (T.isRoot(p))
+			break;
+	}
+}
+
+template <class NodeType, class C>
+void MinMaxHeap<NodeType, C>::insert(const NodeType& e)
+{
+	T.addLast(e);
+	bubbleUp(T.last());
+}
+
+template <class NodeType, class C>
+typename MinMaxHeap<NodeType, C>::Position MinMaxHeap<NodeType, C>::maxPosition()
+{
+	Position r = T.root();
+	if (!T.hasLeft(r))
+		return r;
+	if (T.hasRight(r) && isLess(*T.left(r), *T.right(r)))
+		return T.right(r);
+	return T.left(r);
+}
+
+template <class NodeType, class C>
+void MinMaxHeap<NodeType, C>::removeAt(Position p)
+{
+	Position last = T.last();
+	if (p != last)
+		*p = std::move(*last); // the last element refills the hole
+	T.removeLast();
+	if (p == last)
+		return;
+	if (onMinLevel(p))
+		trickleDown<false>(p);
+	else
+		trickleDown<true>(p);
+}
+
+template <class NodeType, class C>
+void MinMaxHeap<NodeType, C>::bubbleUp(Position p)
+{
+	if (T.isRoot(p))
+		return;
+	Position u = T.parent(p);
+	if (onMinLevel(p)) {
+		if (isLess(*u, *p)) { // greater than a max-level parent
+			T.swap(p, u);
+			bubbleUpLevels<true>(u);
+		}
+		else
+			bubbleUpLevels<false>(p);
+	}
+	else {
+		if (isLess(*p, *u)) { // smaller than a min-level parent
+			T.swap(p, u);
+			bubbleUpLevels<false>(u);
+		}
+		else
+			bubbleUpLevels<true>(p);
+	}
+}
+
+template <class NodeType, class C>
+template <bool Max>
+void MinMaxHeap<NodeType, C>::bubbleUpLevels(Position p)
+{
+	// compare with the grandparent, the nearest ancestor on the same kind of level
+	while (!T.isRoot(p) && !T.isRoot(T.parent(p))) {
+		Position g = T.parent(T.parent(p));
+		if (!before<Max>(*p, *g))
+			break;
+		T.swap(p, g);
+		p = g;
+	}
+}
+
+template <class NodeType, class C>
+template <bool Max>
+void MinMaxHeap<NodeType, C>::trickleDown(Position p)
+{
+	while (T.hasLeft(p)) {
+		// m : the first of p's children and grandchildren in this level's order
+		Position m = T.left(p);
+		bool grandchild = false;
+		for (int c = 0; c < 2; c++) {
+			if (c == 1 && !T.hasRight(p))
+				break;
+			Position child = c == 0 ? T.left(p) : T.right(p);
+			if (before<Max>(*child, *m)) {
+				m = child;
+				grandchild = false;
+			}
+			if (T.hasLeft(child) && before<Max>(*T.left(child), *m)) {
+				m = T.left(child);
+				grandchild = true;
+			}
+			if (T.hasRight(child) && before<Max>(*T.right(child), *m)) {
+				m = T.right(child);
+				grandchild = true;
+			}
+		}
+		if (!before<Max>(*m, *p))
+			return;
+		T.swap(m, p);
+		if (!grandchild)
+			return;
+		Position u = T.parent(m); // the level between, of the other kind
+		if (before<Max>(*u, *m))
+			T.swap(m, u);
+		p = m;
+	}
+}
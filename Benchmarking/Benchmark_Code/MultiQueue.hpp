@@ -0,0 +1,130 @@
+#pragma once
+/**
+	Description :
+	MultiQueue : Relaxed Concurrent Priority Queue
+
+	c * threads HeapPriorityQueue shards, each behind its own lock on its
+	own cache line. insert() locks a random free shard. tryRemoveMin()
+	locks two random shards and pops the smaller of their minima, so the
+	removed element is close to, but not always, the global minimum. A
+	larger c spreads the contention over more locks and increases the
+	rank error (how many smaller elements were present when one was
+	removed), c = 2 is the usual choice.
+
+	A busy shard is skipped and another one drawn at random instead of
+	waiting for its lock; only the final scan of an apparently empty
+	queue blocks.
+**/
+
+#include <cstdint> // uint64_t
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <vector> // std::vector
+
+#include "HeapPriorityQueue.hpp"
+
+template <class NodeType, class C = Compare<NodeType>>
+class MultiQueue
+{
+public:
+	// threads that will use the queue, c shards per thread (at least 2 in all)
+	explicit MultiQueue(unsigned threads, unsigned c = 2);
+	MultiQueue(const MultiQueue&) = delete;
+	MultiQueue& operator=(const MultiQueue&) = delete;
+
+	unsigned shards() const { return static_cast<unsigned>(queues.size()); }
+	void insert(const NodeType& e);
+	// pop a small element into out, false once every shard was found empty
+	bool tryRemoveMin(NodeType& out);
+private:
+	struct alignas(64) Shard {
+		std::mutex lock;
+		HeapPriorityQueue<NodeType, C> heap;
+	};
+
+	unsigned pick(); // random shard
+	bool scanAll(NodeType& out);
+
+	std::vector<std::unique_ptr<Shard>> queues;
+	C isLess;
+};
+
+template <class NodeType, class C>
+MultiQueue<NodeType, C>::MultiQueue(unsigned threads, unsigned c)
+{
+	unsigned n = threads * c;
+	if (n < 2)
+		n = 2;
+	for (unsigned i = 0; i < n; i++)
+		queues.emplace_back(new Shard);
+}
+
+template <class NodeType, class C>
+unsigned MultiQueue<NodeType, C>::pick()
+{
+	// xorshift, each thread its own stream
+	static thread_local uint64_t seed = 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(&seed);
+	seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+	return static_cast<unsigned>(seed % queues.size());
+}
+
+template <class NodeType, class C>
+void MultiQueue<NodeType, C>::insert(const NodeType& e)
+{
+	for (;;) {
+		Shard& s = *queues[pick()];
+		if (s.lock.try_lock()) {
+			s.heap.insert(e);
+			s.lock.unlock();
+			return;
+		}
+	}
+}
+
+template <class NodeType, class C>
+bool MultiQueue<NodeType, C>::tryRemoveMin(NodeType& out)
+{
+	unsigned emptyPairs = 0;
+	while (emptyPairs < shards()) {
+		unsigned i = pick(), j = pick();
+		if (i == j)
+			continue;
+		Shard& a = *queues[i];
+		Shard& b = *queues[j];
+		if (!a.lock.try_lock())
+			continue;
+		if (!b.lock.try_lock()) {
+			a.lock.unlock();
+			continue;
+		}
+		Shard* best = nullptr; // the shard with the smaller minimum
+		if (!a.heap.empty())
+			best = &a;
+		if (!b.heap.empty() && (!best || isLess(b.heap.min(), a.heap.min())))
+			best = &b;
+		if (best) {
+			out = best->heap.min();
+			best->heap.removeMin();
+		}
+		b.lock.unlock();
+		a.lock.unlock();
+		if (best)
+			return true;
+		emptyPairs++;
+	}
+	return scanAll(out); // mostly empty, look everywhere before giving up
+}
+
+template <class NodeType, class C>
+bool MultiQueue<NodeType, C>::scanAll(NodeType& out)
+{
+	for (auto& s : queues) {
+		std::lock_guard<std::mutex> guard(s->lock);
+		if (!s->heap.empty()) {
+			out = s->heap.min();
+			s->heap.removeMin();
+			return true;
+		}
+	}
+	return false;
+}
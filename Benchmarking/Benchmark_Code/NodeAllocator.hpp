@@ -0,0 +1,146 @@
+#pragma once
+/**
+	Description :
+	Node Allocator Policies for LinkedList
+
+	NewNodeAllocator : one new / delete per node, the original behaviour.
+
+	PooledNodeAllocator : nodes are carved in order out of chunks of
+	ChunkNodes nodes, so a list built front to back lies contiguously in
+	memory, and freed nodes go on an intrusive free list (the next
+	pointer lives in the dead node itself) to be reused first.
+	releaseAll() forgets every node at once, O(1), and keeps the chunks
+	for the next nodes; they are returned to the system when the
+	allocator is destroyed.
+
+	A policy provides allocate() / deallocate() for one Node, releaseAll(),
+	BULK_RELEASE (true when releaseAll() makes per-node deallocation
+	unnecessary) and ==, which is true when nodes from one allocator may
+	be deallocated by the other. Pools are never shared : copying a pooled
+	allocator starts a new, empty pool, and two pooled allocators are
+	equal only if they are the same object.
+
+	swap() exchanges two allocators with their nodes, and adopt() takes
+	over every node of an unequal allocator (its chunks and free list)
+	and leaves it empty, so LinkedList can move, splice and merge nodes
+	between lists without copying them.
+**/
+
+#include <cstddef> // size_t
+#include <new> // placement new
+#include <vector> // std::vector
+#include <utility> // std::swap
+
+template <class NodeType>
+struct Node;
+
+template <class NodeType>
+class NewNodeAllocator
+{
+public:
+	static constexpr bool BULK_RELEASE = false;
+
+	Node<NodeType>* allocate() { return new Node<NodeType>; }
+	void deallocate(Node<NodeType>* p) { delete p; }
+	void releaseAll() {}
+	void swap(NewNodeAllocator&) noexcept {}
+	void adopt(NewNodeAllocator&) {}
+	bool operator == (const NewNodeAllocator&) const { return true; }
+	bool operator != (const NewNodeAllocator&) const { return false; }
+};
+
+template <class NodeType, size_t ChunkNodes = 256>
+class PooledNodeAllocator
+{
+public:
+	static constexpr bool BULK_RELEASE = true;
+
+	PooledNodeAllocator() : chunk(0), bump(nullptr), bumpEnd(nullptr), freeList(nullptr), freeTail(nullptr) {}
+	PooledNodeAllocator(const PooledNodeAllocator&) : PooledNodeAllocator() {}
+	PooledNodeAllocator& operator=(const PooledNodeAllocator&) { return *this; } // keeps its own pool
+	~PooledNodeAllocator()
+	{
+		for (Node<NodeType>* c : chunks)
+			::operator delete(c);
+	}
+
+	Node<NodeType>* allocate()
+	{
+		Node<NodeType>* p;
+		if (freeList) {
+			p = reinterpret_cast<Node<NodeType>*>(freeList);
+			freeList = freeList->next;
+		}
+		else {
+			if (bump == bumpEnd)
+				nextChunk();
+			p = bump++;
+		}
+		return new (p) Node<NodeType>;
+	}
+	void deallocate(Node<NodeType>* p)
+	{
+		p->~Node<NodeType>();
+		FreeNode* f = new (p) FreeNode{ freeList };
+		if (freeList == nullptr)
+			freeTail = f;
+		freeList = f;
+	}
+	// every node allocated so far is gone, without destructors
+	void releaseAll()
+	{
+		freeList = freeTail = nullptr;
+		chunk = 0;
+		bump = bumpEnd = nullptr;
+	}
+	void swap(PooledNodeAllocator& that) noexcept
+	{
+		chunks.swap(that.chunks);
+		std::swap(chunk, that.chunk);
+		std::swap(bump, that.bump);
+		std::swap(bumpEnd, that.bumpEnd);
+		std::swap(freeList, that.freeList);
+		std::swap(freeTail, that.freeTail);
+	}
+	// that's chunks and free nodes become ours, that is left with an empty
+	// pool; the unused rest of its current chunk waits for our releaseAll()
+	void adopt(PooledNodeAllocator& that)
+	{
+		if (this == &that)
+			return;
+		chunks.insert(chunks.begin() + chunk, that.chunks.begin(), that.chunks.begin() + that.chunk);
+		chunk += that.chunk;
+		chunks.insert(chunks.end(), that.chunks.begin() + that.chunk, that.chunks.end());
+		if (that.freeList) {
+			that.freeTail->next = freeList;
+			if (freeList == nullptr)
+				freeTail = that.freeTail;
+			freeList = that.freeList;
+		}
+		that.chunks.clear();
+		that.releaseAll();
+	}
+	bool operator == (const PooledNodeAllocator& that) const { return this == &that; }
+	bool operator != (const PooledNodeAllocator& that) const { return this != &that; }
+private:
+	struct FreeNode {
+		FreeNode* next;
+	};
+	static_assert(sizeof(Node<NodeType>) >= sizeof(FreeNode), "a free node must hold a pointer");
+
+	// bump through the kept chunks before asking for a new one
+	void nextChunk()
+	{
+		if (chunk == chunks.size())
+			chunks.push_back(static_cast<Node<NodeType>*>(::operator new(ChunkNodes * sizeof(Node<NodeType>))));
+		bump = chunks[chunk++];
+		bumpEnd = bump + ChunkNodes;
+	}
+
+	std::vector<Node<NodeType>*> chunks;
+	size_t chunk; // chunks[0, chunk) have been bumped through
+	Node<NodeType>* bump;
+	Node<NodeType>* bumpEnd;
+	FreeNode* freeList;
+	FreeNode* freeTail; // adopt() links the free lists in O(1)
+};
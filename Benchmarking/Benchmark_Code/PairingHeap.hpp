@@ -0,0 +1,183 @@
+#pragma once
+/**
+	Description :
+	Pairing Heap with a Pooled Node Allocator and O(1) Meld
+
+	A heap-ordered tree of any shape : every node keeps its first child
+	and its next sibling. insert() and meld() link two roots with one
+	comparison, the larger root becoming the first child of the smaller.
+	removeMin() re-links the root's children in two passes, pairs left
+	to right then the pairs right to left, O(log n) amortized.
+
+	Nodes come from chunks of CHUNK_NODES owned by the heap, recycled
+	through a free list, so a pop and a push cost no malloc. meld()
+	hands the other heap's chunks over along with its tree, so nodes
+	never move and the other heap is left empty.
+
+	Same interface as HeapPriorityQueue plus meld().
+**/
+
+#include <cstddef> // size_t
+#include <new> // placement new
+#include <utility> // std::swap
+#include <vector> // std::vector
+#include <type_traits> // std::is_trivially_destructible
+
+#include "VectorCompleteTree.hpp" // Compare
+
+template <class NodeType, class C = Compare<NodeType>>
+class PairingHeap
+{
+public:
+	PairingHeap() : root(nullptr), count(0), bump(nullptr), bumpEnd(nullptr), freeList(nullptr), freeTail(nullptr) {}
+	~PairingHeap();
+	PairingHeap(const PairingHeap&) = delete;
+	PairingHeap& operator=(const PairingHeap&) = delete;
+
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	void insert(const NodeType& e);
+	const NodeType& min() { return root->data; }
+	void removeMin();
+	// move every element of other into this heap, O(1) plus O(chunks of other)
+	void meld(PairingHeap& other);
+private:
+	struct PNode {
+		NodeType data;
+		PNode* child;
+		PNode* sibling;
+	};
+	static constexpr size_t CHUNK_NODES = 1024;
+
+	PNode* link(PNode* a, PNode* b)
+	{
+		if (isLess(b->data, a->data))
+			std::swap(a, b);
+		b->sibling = a->child; // b becomes a's first child
+		a->child = b;
+		return a;
+	}
+	PNode* allocate(const NodeType& e);
+	void release(PNode* p);
+
+	PNode* root;
+	int count;
+	C isLess;
+	std::vector<PNode*> chunks; // raw storage, CHUNK_NODES nodes each
+	PNode* bump; // next never-used node of the newest chunk
+	PNode* bumpEnd;
+	PNode* freeList; // recycled nodes, linked through sibling
+	PNode* freeTail;
+};
+
+template <class NodeType, class C>
+PairingHeap<NodeType, C>::~PairingHeap()
+{
+	if (!std::is_trivially_destructible<NodeType>::value && root) {
+		std::vector<PNode*> stack(1, root);
+		while (!stack.empty()) {
+			PNode* p = stack.back();
+			stack.pop_back();
+			if (p->child) stack.push_back(p->child);
+			if (p->sibling) stack.push_back(p->sibling);
+			p->data.~NodeType();
+		}
+	}
+	for (PNode* chunk : chunks)
+		::operator delete(chunk);
+}
+
+template <class NodeType, class C>
+typename PairingHeap<NodeType, C>::PNode* PairingHeap<NodeType, C>::allocate(const NodeType& e)
+{
+	PNode* p;
+	if (freeList) {
+		p = freeList;
+		freeList = p->sibling;
+		if (!freeList)
+			freeTail = nullptr;
+	}
+	else {
+		if (bump == bumpEnd) {
+			bump = static_cast<PNode*>(::operator new(CHUNK_NODES * sizeof(PNode)));
+			bumpEnd = bump + CHUNK_NODES;
+			chunks.push_back(bump);
+		}
+		p = bump++;
+	}
+	return new (p) PNode{ e, nullptr, nullptr };
+}
+
+template <class NodeType, class C>
+void PairingHeap<NodeType, C>::release(PNode* p)
+{
+	p->data.~NodeType();
+	p->sibling = freeList;
+	freeList = p;
+	if (!freeTail)
+		freeTail = p;
+}
+
+template <class NodeType, class C>
+void PairingHeap<NodeType, C>::insert(const NodeType& e)
+{
+	PNode* p = allocate(e);
+	root = root ? link(root, p) : p;
+	count++;
+}
+
+template <class NodeType, class C>
+void PairingHeap<NodeType, C>::removeMin()
+{
+	PNode* old = root;
+	// pass 1 : link the children in pairs, left to right, stacking the results
+	PNode* pairs = nullptr;
+	PNode* next = old->child;
+	while (next) {
+		PNode* a = next;
+		PNode* b = a->sibling;
+		if (!b) {
+			a->sibling = pairs;
+			pairs = a;
+			break;
+		}
+		next = b->sibling;
+		a = link(a, b);
+		a->sibling = pairs;
+		pairs = a;
+	}
+	// pass 2 : link the stacked pairs, last pair first
+	root = nullptr;
+	while (pairs) {
+		next = pairs->sibling;
+		pairs->sibling = nullptr;
+		root = root ? link(root, pairs) : pairs;
+		pairs = next;
+	}
+	release(old);
+	count--;
+}
+
+template <class NodeType, class C>
+void PairingHeap<NodeType, C>::meld(PairingHeap& other)
+{
+	if (this == &other)
+		return;
+	if (other.root)
+		root = root ? link(root, other.root) : other.root;
+	count += other.count;
+	chunks.insert(chunks.end(), other.chunks.begin(), other.chunks.end());
+	if (other.freeList) { // append the other free list
+		if (freeTail)
+			freeTail->sibling = other.freeList;
+		else
+			freeList = other.freeList;
+		freeTail = other.freeTail;
+	}
+	// the unused tail of the other's newest chunk is given up
+	other.root = nullptr;
+	other.count = 0;
+	other.chunks.clear();
+	other.bump = other.bumpEnd = nullptr;
+	other.freeList = other.freeTail = nullptr;
+}
@@ -0,0 +1,216 @@
+#pragma once
+/**
+	Description :
+	Hardware Performance Counters Read Around a Timed Region
+
+	Opens one Linux perf_event_open counter per event for the calling
+	thread and every thread it starts afterwards (user space only), so
+	rows timed on a thread pool count the workers too as long as the pool
+	is created after open(). Each event is opened on its own instead of
+	as a group so a missing event (no PMU in a VM, dTLB not exposed, ...)
+	only disables that column. If nothing can be opened, e.g. inside a
+	container with perf_event_paranoid locked down, available() is false
+	and the benchmark reports wall time only.
+
+	Usage :
+		PerfCounters counters;
+		counters.open();
+		counters.start(); ...timed region... counters.stop();
+		counters.value(PERF_CYCLES);
+**/
+
+#include <cstdint> // uint64_t
+#include <cstring> // std::memset, std::strerror
+#include <cerrno> // errno
+#include <string> // std::string
+
+#ifdef __linux__
+#include <linux/perf_event.h> // perf_event_attr
+#include <sys/ioctl.h> // ioctl()
+#include <sys/syscall.h> // SYS_perf_event_open
+#include <unistd.h> // syscall(), read(), close()
+#endif
+
+enum PerfEvent {
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_L1D_MISSES,
+	PERF_LLC_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_DTLB_MISSES,
+	NUM_PERF_EVENTS
+};
+
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters() { close(); }
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// try to open every event, returns true if at least one opened
+	bool open();
+	void close();
+	// reset and enable all open counters
+	void start();
+	// disable all open counters and latch their values
+	void stop();
+
+	bool available() const;
+	bool available(PerfEvent e) const { return fd[e] >= 0; }
+	// counter value from the last start()/stop() pair, scaled if multiplexed
+	uint64_t value(PerfEvent e) const { return count[e]; }
+	// reason the last failed event could not be opened
+	const std::string& error() const { return lastError; }
+
+	static const char* name(PerfEvent e);
+private:
+	int fd[NUM_PERF_EVENTS];
+	uint64_t count[NUM_PERF_EVENTS];
+	uint64_t base[NUM_PERF_EVENTS][3]; // value, time enabled, time running at start()
+	std::string lastError;
+};
+
+inline PerfCounters::PerfCounters()
+{
+	for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+		fd[i] = -1;
+		count[i] = 0;
+		base[i][0] = base[i][1] = base[i][2] = 0;
+	}
+}
+
+inline const char* PerfCounters::name(PerfEvent e)
+{
+	switch (e) {
+	case PERF_CYCLES: return "CYC/EL";
+	case PERF_INSTRUCTIONS: return "INS/EL";
+	case PERF_L1D_MISSES: return "L1DM/EL";
+	case PERF_LLC_MISSES: return "LLCM/EL";
+	case PERF_BRANCH_MISSES: return "BRM/EL";
+	case PERF_DTLB_MISSES: return "TLBM/EL";
+	default: return "?";
+	}
+}
+
+inline bool PerfCounters::available() const
+{
+	for (int i = 0; i < NUM_PERF_EVENTS; i++)
+		if (fd[i] >= 0)
+			return true;
+	return false;
+}
+
+#ifdef __linux__
+
+inline bool PerfCounters::open()
+{
+	close();
+	for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1; // allowed with perf_event_paranoid <= 2
+		attr.exclude_hv = 1;
+		attr.inherit = 1; // threads started later count into this fd, read one by one (no PERF_FORMAT_GROUP)
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		switch (i) {
+		case PERF_CYCLES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case PERF_INSTRUCTIONS:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case PERF_L1D_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case PERF_LLC_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case PERF_BRANCH_MISSES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		case PERF_DTLB_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		}
+
+		// this thread, any cpu, no group
+		fd[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		if (fd[i] < 0)
+			lastError = std::string(name(static_cast<PerfEvent>(i))) + ": " + std::strerror(errno);
+	}
+	return available();
+}
+
+inline void PerfCounters::close()
+{
+	for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+		if (fd[i] >= 0)
+			::close(fd[i]);
+		fd[i] = -1;
+	}
+}
+
+// RESET does not clear what exited inherited threads folded into the
+// counter, so start() latches a baseline and stop() reports the difference
+inline void PerfCounters::start()
+{
+	for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+		if (fd[i] >= 0) {
+			ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+			if (read(fd[i], base[i], sizeof(base[i])) != sizeof(base[i]))
+				base[i][0] = base[i][1] = base[i][2] = 0;
+			ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+inline void PerfCounters::stop()
+{
+	for (int i = 0; i < NUM_PERF_EVENTS; i++)
+		if (fd[i] >= 0)
+			ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+
+	for (int i = 0; i < NUM_PERF_EVENTS; i++) {
+		count[i] = 0;
+		if (fd[i] < 0)
+			continue;
+		uint64_t buf[3]; // value, time enabled, time running
+		if (read(fd[i], buf, sizeof(buf)) != sizeof(buf))
+			continue;
+		for (int j = 0; j < 3; j++)
+			buf[j] -= base[i][j];
+		// scale up if the PMU had to multiplex this counter
+		if (buf[2] > 0 && buf[2] < buf[1])
+			count[i] = static_cast<uint64_t>(static_cast<double>(buf[0]) * buf[1] / buf[2]);
+		else
+			count[i] = buf[0];
+	}
+}
+
+#else // counters are Linux only
+
+inline bool PerfCounters::open()
+{
+	lastError = "perf_event_open requires Linux";
+	return false;
+}
+
+inline void PerfCounters::close() {}
+inline void PerfCounters::start() {}
+inline void PerfCounters::stop() {}
+
+#endif
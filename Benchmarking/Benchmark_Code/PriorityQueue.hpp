@@ -1,73 +1,140 @@
 #pragma once
+#include <vector> // std::vector
+#include <algorithm> // std::sort, std::partial_sort
 #include "LinkedList.hpp"
+#include "IntrusiveList.hpp"
 
-template <class NodeType>
+namespace pq_detail {
+
+	// a LinkedList whose nodes come from Alloc, elements copied in
+	template <class NodeType, class Alloc>
+	struct Storage {
+		typedef LinkedList<NodeType, Alloc> List;
+		typedef NodeType Item;
+	};
+
+	// the elements are the nodes, linked in place through ListHook<NodeType, Tag>
+	template <class NodeType, class Tag>
+	struct Storage<NodeType, IntrusiveNodes<Tag>> {
+		typedef IntrusiveList<NodeType, Tag> List;
+		typedef NodeType& Item;
+	};
+}
+
+// Alloc is the node allocator policy of the underlying LinkedList,
+// or IntrusiveNodes<Tag> to link the inserted objects themselves
+template <class NodeType, class Alloc = NewNodeAllocator<NodeType>>
 class PriorityQueue {
+	typedef typename pq_detail::Storage<NodeType, Alloc>::List List;
 public:
-	void insert(NodeType t);
-	Node<NodeType>* findMin();
+	typedef typename List::Position Position;
+
+	void insert(typename pq_detail::Storage<NodeType, Alloc>::Item t);
+	Position findMin();
 	NodeType& min();
 	void removeMin();
+	// move the k smallest to out in ascending order, one scan and a partial sort
+	template <class OutputIt>
+	OutputIt popN(int k, OutputIt out);
+	// move everything to out in ascending order and leave the queue empty
+	template <class OutputIt>
+	OutputIt drainSorted(OutputIt out);
 	void display();
 	int size();
 	bool isEmpty();
 private:
-	LinkedList<NodeType> q;
+	List q;
 };
 
-template <class NodeType>
-void PriorityQueue<NodeType>::insert(NodeType t)
+template <class NodeType, class Alloc>
+void PriorityQueue<NodeType, Alloc>::insert(typename pq_detail::Storage<NodeType, Alloc>::Item t)
 {
 	q.insertFront(t);
 }
 
-template <class NodeType>
-Node<NodeType>* PriorityQueue<NodeType>::findMin()
+template <class NodeType, class Alloc>
+typename PriorityQueue<NodeType, Alloc>::Position PriorityQueue<NodeType, Alloc>::findMin()
 {
-	Node<NodeType>* ptr = q.head->next;
-	int min = ptr->data;
-	Node<NodeType>* minPtr = ptr;
+	Position ptr = q.first();
+	Position minPtr = ptr;
 
 	while (ptr) // is not null
 	{
-		if (ptr->data < min)
-		{
-			min = ptr->data;
+		if (List::data(ptr) < List::data(minPtr))
 			minPtr = ptr;
-		}
-		ptr = ptr->next;
+		ptr = List::next(ptr);
 	}
 	return minPtr;
 }
 
-template <class NodeType>
-NodeType& PriorityQueue<NodeType>::min()
+template <class NodeType, class Alloc>
+NodeType& PriorityQueue<NodeType, Alloc>::min()
 {
-	Node<NodeType>* minPtr = findMin();
-	return minPtr->data;
+	return List::data(findMin());
 }
 
-template <class NodeType>
-void PriorityQueue<NodeType>::removeMin()
+template <class NodeType, class Alloc>
+void PriorityQueue<NodeType, Alloc>::removeMin()
 {
-	NodeType x = q.erase(findMin());
+	q.erase(findMin());
+}
+
+template <class NodeType, class Alloc>
+template <class OutputIt>
+OutputIt PriorityQueue<NodeType, Alloc>::popN(int k, OutputIt out)
+{
+	if (k >= size())
+		return drainSorted(out);
+	if (k <= 0)
+		return out;
+	std::vector<Position> nodes;
+	nodes.reserve(size());
+	for (Position p = q.first(); p; p = List::next(p))
+		nodes.push_back(p);
+	std::partial_sort(nodes.begin(), nodes.begin() + k, nodes.end(),
+		[](Position a, Position b) { return List::data(a) < List::data(b); });
+	for (int i = 0; i < k; i++) {
+		*out = List::data(nodes[i]);
+		++out;
+		q.erase(nodes[i]);
+	}
+	return out;
+}
+
+template <class NodeType, class Alloc>
+template <class OutputIt>
+OutputIt PriorityQueue<NodeType, Alloc>::drainSorted(OutputIt out)
+{
+	if (q.empty())
+		return out;
+	std::vector<NodeType> all;
+	all.reserve(size());
+	for (Position p = q.first(); p; p = List::next(p))
+		all.push_back(List::data(p));
+	std::sort(all.begin(), all.end());
+	q.clear();
+	for (auto& e : all) {
+		*out = std::move(e);
+		++out;
+	}
+	return out;
 }
 
 //display
-template <class NodeType>
-void PriorityQueue<NodeType>::display()
+template <class NodeType, class Alloc>
+void PriorityQueue<NodeType, Alloc>::display()
 {
 	q.Display();
 }
 
-template <class NodeType>
-bool PriorityQueue<NodeType>::isEmpty()
+template <class NodeType, class Alloc>
+bool PriorityQueue<NodeType, Alloc>::isEmpty()
 {
 	return q.empty();
 }
 
-template<class NodeType>
-int PriorityQueue<NodeType>::size()
+template <class NodeType, class Alloc>
+int PriorityQueue<NodeType, Alloc>::size()
 {
 	return q.size();
 }
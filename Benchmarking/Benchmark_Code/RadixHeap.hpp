@@ -0,0 +1,115 @@
+#pragma once
+/**
+	Description :
+	Monotone Radix Heap for Integer Keys
+
+	For workloads that never insert a key below the last removed minimum
+	(event simulation, Dijkstra, PQ sort). Bucket 0 holds keys equal to
+	the last minimum, bucket i the keys whose highest bit differing from
+	it is bit i - 1. removeMin() takes from bucket 0; when that is empty
+	the first non-empty bucket is emptied into lower buckets around its
+	own minimum. Every key moves to a lower bucket at most once per bit,
+	so insert is O(1) and removeMin O(bits) amortized, with no key
+	comparisons between elements.
+
+	Signed keys are mapped to unsigned by flipping the sign bit, which
+	keeps their order. Same interface as HeapPriorityQueue.
+**/
+
+#include <vector> // std::vector
+#include <type_traits> // std::is_integral, std::make_unsigned, std::is_signed
+#include <stdexcept> // std::invalid_argument
+#ifdef _MSC_VER
+#include <intrin.h> // _BitScanReverse64
+#endif
+
+template <class T>
+class RadixHeap
+{
+	static_assert(std::is_integral<T>::value, "RadixHeap needs integer keys");
+	typedef typename std::make_unsigned<T>::type U;
+	static constexpr int BITS = static_cast<int>(sizeof(T) * 8);
+public:
+	RadixHeap() : count(0), last(0), top(fromUnsigned(0)) {}
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	// e must not be smaller than the last removed minimum
+	void insert(const T& e);
+	const T& min();
+	void removeMin();
+private:
+	static U toUnsigned(T x) { return static_cast<U>(x) ^ SIGN; }
+	static T fromUnsigned(U x) { return static_cast<T>(x ^ SIGN); }
+	// 0 if x equals the last minimum, else the bit length of x ^ last
+	int bucketOf(U x) const
+	{
+		unsigned long long d = static_cast<unsigned long long>(x ^ last);
+		if (d == 0)
+			return 0;
+#if defined(__GNUC__)
+		return 64 - __builtin_clzll(d);
+#elif defined(_MSC_VER)
+		unsigned long bit;
+		_BitScanReverse64(&bit, d);
+		return static_cast<int>(bit) + 1;
+#else
+		int bits = 0;
+		for (; d; d >>= 1)
+			bits++;
+		return bits;
+#endif
+	}
+	void refill(); // bucket 0 is empty, pull down the next non-empty bucket
+
+	static constexpr U SIGN = std::is_signed<T>::value ? static_cast<U>(U(1) << (BITS - 1)) : U(0);
+
+	std::vector<U> buckets[BITS + 1];
+	int count;
+	U last; // last minimum, every key is at least this
+	T top;
+};
+
+template <class T>
+void RadixHeap<T>::insert(const T& e)
+{
+	U x = toUnsigned(e);
+	if (x < last)
+		throw std::invalid_argument("Error: radix heap key below the last minimum");
+	buckets[bucketOf(x)].push_back(x);
+	count++;
+}
+
+template <class T>
+const T& RadixHeap<T>::min()
+{
+	if (buckets[0].empty())
+		refill();
+	return top;
+}
+
+template <class T>
+void RadixHeap<T>::removeMin()
+{
+	if (buckets[0].empty())
+		refill();
+	buckets[0].pop_back();
+	count--;
+}
+
+template <class T>
+void RadixHeap<T>::refill()
+{
+	int i = 1;
+	while (buckets[i].empty())
+		i++;
+	std::vector<U>& from = buckets[i];
+	U m = from[0];
+	for (U x : from)
+		if (x < m)
+			m = x;
+	last = m;
+	top = fromUnsigned(m);
+	for (U x : from) // each key lands in a bucket below i
+		buckets[bucketOf(x)].push_back(x);
+	from.clear();
+}
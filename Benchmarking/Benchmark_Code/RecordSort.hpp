@@ -0,0 +1,123 @@
+#pragma once
+/**
+	Description :
+	Sorting Large Records by an Extracted Key
+
+	Indirect (key-pointer) mode : extract a compact (key, index) array,
+	sort that, then apply the permutation to the records in place by
+	following its cycles. Every record is moved n + (number of cycles)
+	times in total, instead of O(n log n) times by a direct sort. Ties
+	are broken by index, so the mode is stable.
+
+	Packed mode : the key and a fixed-size payload live in one trivially
+	copyable struct, so a direct sort moves a flat block of bytes with
+	no pointer chasing or string moves. packRecord() fills one from a
+	(key, string) record such as the passenger entries of the BST demo,
+	truncating the string to the payload size.
+**/
+
+#include <cstdint> // uint32_t
+#include <cstring> // std::memcpy, std::memset
+#include <string> // std::string
+#include <vector> // std::vector
+#include <iterator> // std::iterator_traits
+#include <type_traits> // std::decay
+#include <algorithm> // std::sort
+#include <utility> // std::move
+
+template <class Key, class Index = uint32_t>
+struct KeyIndex {
+	Key key;
+	Index index;
+};
+
+// reorder [first, first + perm.size()) so position i receives the record
+// that was at perm[i]; perm is used as scratch and left as the identity
+template <class RandomIt, class Index>
+void applyPermutation(RandomIt first, std::vector<Index>& perm)
+{
+	typedef typename std::iterator_traits<RandomIt>::value_type Record;
+	for (size_t i = 0; i < perm.size(); i++) {
+		if (perm[i] == static_cast<Index>(i))
+			continue;
+		// walk the cycle through i, shifting each record one step
+		Record x = std::move(first[i]);
+		size_t j = i;
+		while (static_cast<size_t>(perm[j]) != i) {
+			size_t next = static_cast<size_t>(perm[j]);
+			first[j] = std::move(first[next]);
+			perm[j] = static_cast<Index>(j);
+			j = next;
+		}
+		first[j] = std::move(x);
+		perm[j] = static_cast<Index>(j);
+	}
+}
+
+namespace record_detail {
+
+	template <class Index, class RandomIt, class KeyFn>
+	void sortThroughIndex(RandomIt first, size_t n, KeyFn key)
+	{
+		typedef typename std::decay<decltype(key(*first))>::type Key;
+		typedef KeyIndex<Key, Index> Entry;
+		std::vector<Entry> keys(n);
+		for (size_t i = 0; i < n; i++)
+			keys[i] = Entry{ key(first[i]), static_cast<Index>(i) };
+		std::sort(keys.begin(), keys.end(), [](const Entry& a, const Entry& b) {
+			return a.key < b.key || (!(b.key < a.key) && a.index < b.index);
+		});
+		std::vector<Index> perm(n);
+		for (size_t i = 0; i < n; i++)
+			perm[i] = keys[i].index;
+		std::vector<Entry>().swap(keys); // release before moving records
+		applyPermutation(first, perm);
+	}
+}
+
+// stable sort of records by key(record) through a (key, index) array
+template <class RandomIt, class KeyFn>
+void sortByKeyIndirect(RandomIt first, RandomIt last, KeyFn key)
+{
+	size_t n = static_cast<size_t>(last - first);
+	if (n < 2)
+		return;
+	// 32-bit indices keep the array compact
+	if (n <= UINT32_MAX)
+		record_detail::sortThroughIndex<uint32_t>(first, n, key);
+	else
+		record_detail::sortThroughIndex<size_t>(first, n, key);
+}
+
+template <class Record, class KeyFn>
+void sortByKeyIndirect(std::vector<Record>& records, KeyFn key)
+{
+	sortByKeyIndirect(records.begin(), records.end(), key);
+}
+
+// key followed by a fixed-size payload, trivially copyable
+template <class Key, size_t PayloadBytes>
+struct PackedRecord {
+	Key key;
+	char payload[PayloadBytes];
+};
+
+// pack (key, text), the text is cut to PayloadBytes - 1 characters
+template <class Key, size_t PayloadBytes>
+PackedRecord<Key, PayloadBytes> packRecord(const Key& key, const std::string& text)
+{
+	PackedRecord<Key, PayloadBytes> r;
+	r.key = key;
+	size_t len = text.size() < PayloadBytes - 1 ? text.size() : PayloadBytes - 1;
+	std::memcpy(r.payload, text.data(), len);
+	std::memset(r.payload + len, 0, PayloadBytes - len);
+	return r;
+}
+
+// direct sort of packed records by key
+template <class Key, size_t PayloadBytes>
+void sortPacked(std::vector<PackedRecord<Key, PayloadBytes>>& records)
+{
+	std::sort(records.begin(), records.end(),
+		[](const PackedRecord<Key, PayloadBytes>& a, const PackedRecord<Key, PayloadBytes>& b) { return a.key < b.key; });
+}
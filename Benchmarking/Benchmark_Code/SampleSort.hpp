@@ -0,0 +1,202 @@
+#pragma once
+/**
+	Description :
+	Parallel Super-Scalar Sample Sort on a Work-Stealing Pool
+
+	Each level :
+	1. Draw alpha * k samples (alpha grows with log n), sort them and keep
+	   every alpha-th one, k - 1 splitters in all.
+	2. Lay the splitters out as an implicit search tree (Eytzinger order)
+	   and classify each element with log2(k) branch-free steps,
+	   j = 2j + (splitter[j] < x), four elements at a time so the loads
+	   overlap. Large ranges are classified block-parallel.
+	3. Prefix-sum the per-block bucket counts and scatter into the
+	   buffer, then sort every bucket as its own stolen-or-not task.
+
+	Ranges below BASE_CASE, or a level that fails to split the input
+	(e.g. all keys equal), finish with std::sort. Not stable.
+**/
+
+#include <cstdint> // uint8_t, uint64_t
+#include <vector> // std::vector
+#include <iterator> // std::iterator_traits
+#include <algorithm> // std::sort, std::move
+
+#include "VectorCompleteTree.hpp" // Compare
+#include "WorkStealingPool.hpp"
+
+template <class RandomIt, class C>
+void parallelSampleSort(RandomIt first, RandomIt last, C isLess, WorkStealingPool& pool);
+
+template <class RandomIt>
+void parallelSampleSort(RandomIt first, RandomIt last, WorkStealingPool& pool)
+{
+	parallelSampleSort(first, last, Compare<typename std::iterator_traits<RandomIt>::value_type>(), pool);
+}
+
+
+namespace sample_detail {
+
+	const size_t BASE_CASE = 4096;				// std::sort below this
+	const size_t PARALLEL_CLASSIFY = 1 << 17;	// block-parallel classification above this
+	const size_t CLASSIFY_BLOCK = 1 << 15;		// elements per classification task
+	const int MAX_LOG_BUCKETS = 8;				// at most 256 buckets per level
+
+	template <class T, class C>
+	class Sorter {
+	public:
+		Sorter(T* data, size_t n, C c, WorkStealingPool& p) : base(data), isLess(c), pool(p), tmp(n), oracle(n) {}
+
+		void sort(size_t n)
+		{
+			pool.run([&]() { sortRange(base, tmp.data(), oracle.data(), n, false, 0); });
+		}
+	private:
+		// data holds the range, other is the matching slice of the other
+		// array; dataIsTmp says which one the result has to end up in
+		void sortRange(T* data, T* other, uint8_t* bucketOf, size_t n, bool dataIsTmp, int depth)
+		{
+			if (n <= BASE_CASE || depth > 8) {
+				std::sort(data, data + n, isLess);
+				if (dataIsTmp)
+					std::move(data, data + n, other);
+				return;
+			}
+
+			// 1. splitters
+			int logK = 1;
+			while (logK < MAX_LOG_BUCKETS && (n / BASE_CASE) >> logK)
+				logK++;
+			size_t k = size_t(1) << logK;
+			int lg = 0;
+			while ((n >> lg) > 1)
+				lg++;
+			size_t alpha = std::max<size_t>(2, lg / 5);
+			std::vector<T> sample(alpha * k - 1);
+			uint64_t state = n * 0x9E3779B97F4A7C15ULL + depth;
+			for (auto& s : sample) {
+				state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+				s = data[state % n];
+			}
+			std::sort(sample.begin(), sample.end(), isLess);
+			std::vector<T> tree(k);
+			buildTree(tree, sample, alpha, 1, 1, k - 1);
+
+			// 2. classify, block-parallel for large ranges
+			size_t blocks = 1;
+			if (n >= PARALLEL_CLASSIFY && pool.threads() > 1)
+				blocks = (n + CLASSIFY_BLOCK - 1) / CLASSIFY_BLOCK;
+			size_t perBlock = (n + blocks - 1) / blocks;
+			std::vector<size_t> counts(blocks * k, 0);
+			forEachBlock(blocks, [&](size_t b) {
+				size_t lo = b * perBlock, hi = std::min(n, lo + perBlock);
+				classify(tree.data(), logK, data + lo, bucketOf + lo, hi - lo, counts.data() + b * k);
+			});
+
+			// 3. bucket offsets, bucket-major then block-major
+			std::vector<size_t> bucketStart(k + 1, 0);
+			std::vector<size_t> offsets(blocks * k);
+			size_t sum = 0;
+			for (size_t j = 0; j < k; j++) {
+				bucketStart[j] = sum;
+				for (size_t b = 0; b < blocks; b++) {
+					offsets[b * k + j] = sum;
+					sum += counts[b * k + j];
+				}
+				if (sum - bucketStart[j] == n) { // no progress, e.g. all keys equal
+					std::sort(data, data + n, isLess);
+					if (dataIsTmp)
+						std::move(data, data + n, other);
+					return;
+				}
+			}
+			bucketStart[k] = n;
+
+			forEachBlock(blocks, [&](size_t b) {
+				size_t lo = b * perBlock, hi = std::min(n, lo + perBlock);
+				size_t* off = offsets.data() + b * k;
+				for (size_t i = lo; i < hi; i++)
+					other[off[bucketOf[i]]++] = std::move(data[i]);
+			});
+
+			// 4. buckets now live in other, sort each one as a task
+			TaskGroup group;
+			for (size_t j = 0; j < k; j++) {
+				size_t lo = bucketStart[j], m = bucketStart[j + 1] - lo;
+				if (m == 0)
+					continue;
+				if (m <= BASE_CASE)
+					sortRange(other + lo, data + lo, bucketOf + lo, m, !dataIsTmp, depth + 1);
+				else
+					pool.spawn(group, [this, other, data, bucketOf, lo, m, dataIsTmp, depth]() { sortRange(other + lo, data + lo, bucketOf + lo, m, !dataIsTmp, depth + 1); });
+			}
+			pool.wait(group);
+		}
+
+		// in-order fill of the implicit tree from every alpha-th sample
+		void buildTree(std::vector<T>& tree, const std::vector<T>& sample, size_t alpha, size_t node, size_t lo, size_t hi)
+		{
+			if (lo > hi)
+				return;
+			size_t mid = (lo + hi) / 2;
+			tree[node] = sample[mid * alpha - 1];
+			buildTree(tree, sample, alpha, 2 * node, lo, mid - 1);
+			buildTree(tree, sample, alpha, 2 * node + 1, mid + 1, hi);
+		}
+
+		// branch-free descent of the splitter tree, bucket = leaf - k
+		void classify(const T* tree, int logK, const T* data, uint8_t* bucketOf, size_t n, size_t* count)
+		{
+			size_t k = size_t(1) << logK;
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				size_t j0 = 1, j1 = 1, j2 = 1, j3 = 1;
+				for (int l = 0; l < logK; l++) {
+					j0 = 2 * j0 + static_cast<size_t>(isLess(tree[j0], data[i]));
+					j1 = 2 * j1 + static_cast<size_t>(isLess(tree[j1], data[i + 1]));
+					j2 = 2 * j2 + static_cast<size_t>(isLess(tree[j2], data[i + 2]));
+					j3 = 2 * j3 + static_cast<size_t>(isLess(tree[j3], data[i + 3]));
+				}
+				bucketOf[i] = static_cast<uint8_t>(j0 - k); count[j0 - k]++;
+				bucketOf[i + 1] = static_cast<uint8_t>(j1 - k); count[j1 - k]++;
+				bucketOf[i + 2] = static_cast<uint8_t>(j2 - k); count[j2 - k]++;
+				bucketOf[i + 3] = static_cast<uint8_t>(j3 - k); count[j3 - k]++;
+			}
+			for (; i < n; i++) {
+				size_t j = 1;
+				for (int l = 0; l < logK; l++)
+					j = 2 * j + static_cast<size_t>(isLess(tree[j], data[i]));
+				bucketOf[i] = static_cast<uint8_t>(j - k);
+				count[j - k]++;
+			}
+		}
+
+		// fn(0..blocks) as pool tasks, the caller runs the last one
+		template <class F>
+		void forEachBlock(size_t blocks, const F& fn)
+		{
+			TaskGroup group;
+			for (size_t b = 0; b + 1 < blocks; b++)
+				pool.spawn(group, [&fn, b]() { fn(b); });
+			fn(blocks - 1);
+			pool.wait(group);
+		}
+
+		T* base;
+		C isLess;
+		WorkStealingPool& pool;
+		std::vector<T> tmp;
+		std::vector<uint8_t> oracle; // bucket of every element on the current level
+	};
+}
+
+template <class RandomIt, class C>
+void parallelSampleSort(RandomIt first, RandomIt last, C isLess, WorkStealingPool& pool)
+{
+	typedef typename std::iterator_traits<RandomIt>::value_type T;
+	size_t n = static_cast<size_t>(last - first);
+	if (n < 2)
+		return;
+	sample_detail::Sorter<T, C> sorter(&*first, n, isLess, pool);
+	sorter.sort(n);
+}
@@ -0,0 +1,185 @@
+#pragma once
+/**
+	Description :
+	Selection : Introselect, Partial Sort and Streaming Top-k
+
+	introSelect(first, nth, last) rearranges [first, last) like
+	std::nth_element : *nth is the element a full sort would put there,
+	nothing before it is greater and nothing after it is smaller. It runs
+	quickselect with median-of-3 pivots and a three-way partition (so
+	runs of equal keys cost nothing), and after 2 log2(n) rounds without
+	finishing switches to median-of-medians pivots, which bounds the
+	worst case at O(n).
+
+	partialSort(first, middle, last) leaves the middle - first smallest
+	elements sorted at the front in O(n + k log k).
+
+	TopK keeps the k smallest elements of an unbounded stream in a
+	HeapPriorityQueue of size k ordered largest-first, O(log k) per push
+	and O(k) memory.
+**/
+
+#include <cstddef> // size_t
+#include <vector> // std::vector
+#include <iterator> // std::iterator_traits
+#include <algorithm> // std::sort, std::iter_swap, std::reverse
+#include <utility> // std::pair
+
+#include "HeapPriorityQueue.hpp"
+
+namespace select_detail {
+
+	template <class It, class C>
+	void insertionSort(It first, It last, C isLess)
+	{
+		for (It i = first + 1; i < last; ++i)
+			for (It j = i; j > first && isLess(*j, *(j - 1)); --j)
+				std::iter_swap(j, j - 1);
+	}
+
+	template <class It, class C>
+	It medianOf3(It a, It b, It c, C isLess)
+	{
+		if (isLess(*a, *b)) {
+			if (isLess(*b, *c)) return b;
+			return isLess(*a, *c) ? c : a;
+		}
+		if (isLess(*a, *c)) return a;
+		return isLess(*b, *c) ? c : b;
+	}
+
+	// [first, lt) < pivot, [lt, gt) == pivot, [gt, last) > pivot
+	template <class It, class T, class C>
+	std::pair<It, It> partition3(It first, It last, const T& pivot, C isLess)
+	{
+		It lt = first, i = first, gt = last;
+		while (i < gt) {
+			if (isLess(*i, pivot))
+				std::iter_swap(lt++, i++);
+			else if (isLess(pivot, *i))
+				std::iter_swap(i, --gt);
+			else
+				++i;
+		}
+		return std::make_pair(lt, gt);
+	}
+
+	template <class It, class C>
+	void select(It first, It nth, It last, C isLess, int budget);
+
+	// median of the medians of groups of five, moved to the front
+	template <class It, class C>
+	It medianOfMedians(It first, It last, C isLess)
+	{
+		size_t n = static_cast<size_t>(last - first), groups = 0;
+		for (size_t g = 0; g < n; g += 5, groups++) {
+			It lo = first + g, hi = first + std::min(n, g + 5);
+			insertionSort(lo, hi, isLess);
+			std::iter_swap(first + groups, lo + (hi - lo) / 2);
+		}
+		It mid = first + groups / 2;
+		select(first, mid, first + groups, isLess, 0);
+		return mid;
+	}
+
+	template <class It, class C>
+	void select(It first, It nth, It last, C isLess, int budget)
+	{
+		typedef typename std::iterator_traits<It>::value_type T;
+		while (last - first > 16) {
+			It p = budget-- > 0
+				? medianOf3(first, first + (last - first) / 2, last - 1, isLess)
+				: medianOfMedians(first, last, isLess);
+			T pivot = *p;
+			std::pair<It, It> eq = partition3(first, last, pivot, isLess);
+			if (nth < eq.first)
+				last = eq.first;
+			else if (nth >= eq.second)
+				first = eq.second;
+			else
+				return; // nth lands among the pivot's equals
+		}
+		insertionSort(first, last, isLess);
+	}
+}
+
+template <class RandomIt, class C>
+void introSelect(RandomIt first, RandomIt nth, RandomIt last, C isLess)
+{
+	if (last - first < 2 || nth == last)
+		return;
+	int budget = 0;
+	for (auto n = last - first; n > 1; n >>= 1)
+		budget += 2;
+	select_detail::select(first, nth, last, isLess, budget);
+}
+
+template <class RandomIt>
+void introSelect(RandomIt first, RandomIt nth, RandomIt last)
+{
+	introSelect(first, nth, last, Compare<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+template <class RandomIt, class C>
+void partialSort(RandomIt first, RandomIt middle, RandomIt last, C isLess)
+{
+	if (first == middle)
+		return;
+	introSelect(first, middle - 1, last, isLess);
+	std::sort(first, middle - 1, isLess); // *(middle - 1) is already in place
+}
+
+template <class RandomIt>
+void partialSort(RandomIt first, RandomIt middle, RandomIt last)
+{
+	partialSort(first, middle, last, Compare<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+template <class NodeType, class C = Compare<NodeType>>
+class TopK
+{
+public:
+	explicit TopK(size_t k) : limit(k) {}
+	size_t size() const { return static_cast<size_t>(kept.size()); }
+	// the largest of the k kept, only valid if size() > 0
+	const NodeType& threshold() { return kept.min(); }
+	void push(const NodeType& e);
+	// the k smallest seen so far in ascending order, keeps the state
+	std::vector<NodeType> sorted() const;
+private:
+	// puts the largest kept element at the heap's root
+	class Reverse {
+	public:
+		bool operator () (const NodeType& x, const NodeType& y) const { return isLess(y, x); }
+	private:
+		C isLess;
+	};
+
+	size_t limit;
+	HeapPriorityQueue<NodeType, Reverse> kept;
+	C isLess;
+};
+
+template <class NodeType, class C>
+void TopK<NodeType, C>::push(const NodeType& e)
+{
+	if (size() < limit)
+		kept.insert(e);
+	else if (limit > 0 && isLess(e, kept.min())) {
+		kept.removeMin(); // drop the largest kept
+		kept.insert(e);
+	}
+}
+
+template <class NodeType, class C>
+std::vector<NodeType> TopK<NodeType, C>::sorted() const
+{
+	HeapPriorityQueue<NodeType, Reverse> drain = kept;
+	std::vector<NodeType> out;
+	while (!drain.empty()) {
+		out.push_back(drain.min());
+		drain.removeMin();
+	}
+	std::reverse(out.begin(), out.end());
+	return out;
+}
@@ -0,0 +1,247 @@
+#pragma once
+/**
+	Description :
+	Skip List Priority Queue
+
+	The elements are kept sorted in a skip list : every node sits on
+	level 0 and on each level above it with probability 1/4, and a search
+	drops down a level whenever the next node would overshoot, expected
+	O(log n) steps. The minimum is the first node, so min() is O(1) and
+	removeMin() unlinks it from the front of its levels in O(1) expected,
+	without searching. Equal elements come out in insertion order, and
+	begin() / end() iterate the queue in ascending order.
+
+	concurrentInsert() may be called from many threads at once : a node
+	is published on level 0 with a compare-and-swap on its predecessor's
+	link, then on the levels above, retrying from the predecessor when
+	another insert got in between. Without concurrent removals no node is
+	ever unlinked or freed under a reader, so no marking or reclamation is
+	needed. Every other member, removeMin() included, must not overlap
+	with it.
+
+	Same interface as HeapPriorityQueue.
+**/
+
+#include <atomic> // std::atomic
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <functional> // std::hash
+#include <iostream> // cout
+#include <iterator> // std::forward_iterator_tag
+#include <new> // placement new, ::operator new
+#include <thread> // std::this_thread::get_id
+
+#include "VectorCompleteTree.hpp" // Compare
+
+template <class NodeType, class C = Compare<NodeType>>
+class SkipListPriorityQueue
+{
+	static constexpr int MAX_LEVEL = 16; // 4^16 elements before the levels run out
+	struct alignas(NodeType) alignas(std::atomic<void*>) SkipNode {
+		NodeType data;
+		int level;
+		// level links follow the node in the same allocation
+		std::atomic<SkipNode*>* next() { return reinterpret_cast<std::atomic<SkipNode*>*>(this + 1); }
+	};
+public:
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef NodeType value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const NodeType* pointer;
+		typedef const NodeType& reference;
+
+		const_iterator(SkipNode* p = nullptr) : p(p) {}
+		const NodeType& operator*() const { return p->data; }
+		const NodeType* operator->() const { return &p->data; }
+		const_iterator& operator++() { p = p->next()[0].load(std::memory_order_relaxed); return *this; }
+		const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+		bool operator==(const const_iterator& that) const { return p == that.p; }
+		bool operator!=(const const_iterator& that) const { return p != that.p; }
+	private:
+		SkipNode* p;
+	};
+
+	SkipListPriorityQueue();
+	~SkipListPriorityQueue();
+	SkipListPriorityQueue(const SkipListPriorityQueue&) = delete;
+	SkipListPriorityQueue& operator=(const SkipListPriorityQueue&) = delete;
+
+	int size() const { return count.load(std::memory_order_relaxed); }
+	bool empty() const { return size() == 0; }
+	void insert(const NodeType& e);
+	void concurrentInsert(const NodeType& e); // thread safe against itself only
+	const NodeType& min() { return first()->data; }
+	void removeMin();
+	void display();
+
+	const_iterator begin() const { return const_iterator(first()); }
+	const_iterator end() const { return const_iterator(); }
+private:
+	SkipNode* head; // sentinel with MAX_LEVEL links, no data
+	std::atomic<int> height; // levels in use, at least 1
+	std::atomic<int> count;
+	uint64_t seed; // xorshift state for insert()
+	C isLess;
+
+	SkipNode* first() const { return head->next()[0].load(std::memory_order_acquire); }
+	static int randomLevel(uint64_t& state);
+	static SkipNode* makeNode(const NodeType& e, int level);
+	static void freeNode(SkipNode* p);
+	// predecessor of e on level i, starting from pred, after any equal elements
+	SkipNode* findPred(SkipNode* pred, int i, const NodeType& e) const;
+	void raiseHeight(int level);
+};
+
+template <class NodeType, class C>
+SkipListPriorityQueue<NodeType, C>::SkipListPriorityQueue() : height(1), count(0), seed(0x9E3779B97F4A7C15ull)
+{
+	void* mem = ::operator new(sizeof(SkipNode) + MAX_LEVEL * sizeof(std::atomic<SkipNode*>));
+	head = static_cast<SkipNode*>(mem);
+	head->level = MAX_LEVEL; // data is never constructed on the sentinel
+	for (int i = 0; i < MAX_LEVEL; i++)
+		new (head->next() + i) std::atomic<SkipNode*>(nullptr);
+}
+
+template <class NodeType, class C>
+SkipListPriorityQueue<NodeType, C>::~SkipListPriorityQueue()
+{
+	SkipNode* p = first();
+	while (p) {
+		SkipNode* q = p->next()[0].load(std::memory_order_relaxed);
+		freeNode(p);
+		p = q;
+	}
+	::operator delete(head);
+}
+
+// level 1 + k with probability (3/4) (1/4)^k, two random bits per level
+template <class NodeType, class C>
+int SkipListPriorityQueue<NodeType, C>::randomLevel(uint64_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	uint64_t r = state;
+	int level = 1;
+	while ((r & 3) == 0 && level < MAX_LEVEL) {
+		level++;
+		r >>= 2;
+	}
+	return level;
+}
+
+template <class NodeType, class C>
+typename SkipListPriorityQueue<NodeType, C>::SkipNode* SkipListPriorityQueue<NodeType, C>::makeNode(const NodeType& e, int level)
+{
+	void* mem = ::operator new(sizeof(SkipNode) + level * sizeof(std::atomic<SkipNode*>));
+	SkipNode* p = static_cast<SkipNode*>(mem);
+	new (&p->data) NodeType(e);
+	p->level = level;
+	for (int i = 0; i < level; i++)
+		new (p->next() + i) std::atomic<SkipNode*>(nullptr);
+	return p;
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::freeNode(SkipNode* p)
+{
+	p->data.~NodeType();
+	::operator delete(p);
+}
+
+template <class NodeType, class C>
+typename SkipListPriorityQueue<NodeType, C>::SkipNode* SkipListPriorityQueue<NodeType, C>::findPred(SkipNode* pred, int i, const NodeType& e) const
+{
+	for (;;) {
+		SkipNode* succ = pred->next()[i].load(std::memory_order_acquire);
+		if (succ == nullptr || isLess(e, succ->data))
+			return pred;
+		pred = succ;
+	}
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::raiseHeight(int level)
+{
+	int h = height.load(std::memory_order_relaxed);
+	while (h < level && !height.compare_exchange_weak(h, level, std::memory_order_relaxed))
+		;
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::insert(const NodeType& e)
+{
+	int level = randomLevel(seed);
+	SkipNode* node = makeNode(e, level);
+	int h = height.load(std::memory_order_relaxed);
+	if (level > h)
+		h = level;
+	SkipNode* pred = head;
+	for (int i = h - 1; i >= 0; i--) {
+		pred = findPred(pred, i, e);
+		if (i < level) {
+			node->next()[i].store(pred->next()[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			pred->next()[i].store(node, std::memory_order_relaxed);
+		}
+	}
+	height.store(h, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::concurrentInsert(const NodeType& e)
+{
+	thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+	int level = randomLevel(state);
+	SkipNode* node = makeNode(e, level);
+	raiseHeight(level);
+
+	SkipNode* preds[MAX_LEVEL];
+	SkipNode* pred = head;
+	for (int i = height.load(std::memory_order_relaxed) - 1; i >= 0; i--) {
+		pred = findPred(pred, i, e);
+		if (i < level)
+			preds[i] = pred;
+	}
+	// level 0 makes the node part of the queue, the levels above are shortcuts
+	for (int i = 0; i < level; i++) {
+		pred = preds[i];
+		for (;;) {
+			pred = findPred(pred, i, e); // an insert may have landed behind pred since the search
+			SkipNode* succ = pred->next()[i].load(std::memory_order_acquire);
+			node->next()[i].store(succ, std::memory_order_relaxed);
+			if (pred->next()[i].compare_exchange_weak(succ, node, std::memory_order_release, std::memory_order_relaxed))
+				break;
+		}
+	}
+	count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::removeMin()
+{
+	SkipNode* p = first();
+	for (int i = 0; i < p->level; i++) {
+		// p is first on its levels, or behind equals that concurrent
+		// inserts linked in another order than on level 0
+		SkipNode* pred = head;
+		while (pred->next()[i].load(std::memory_order_relaxed) != p)
+			pred = pred->next()[i].load(std::memory_order_relaxed);
+		pred->next()[i].store(p->next()[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	int h = height.load(std::memory_order_relaxed);
+	while (h > 1 && head->next()[h - 1].load(std::memory_order_relaxed) == nullptr)
+		h--;
+	height.store(h, std::memory_order_relaxed);
+	count.fetch_sub(1, std::memory_order_relaxed);
+	freeNode(p);
+}
+
+template <class NodeType, class C>
+void SkipListPriorityQueue<NodeType, C>::display()
+{
+	for (const NodeType& e : *this)
+		std::cout << e << " ";
+}
@@ -0,0 +1,349 @@
+#pragma once
+/**
+	Description :
+	Unrolled Linked List
+
+	A doubly linked list of blocks, each holding up to K elements in an
+	array plus a count. K defaults to a cache line of elements (16 ints),
+	so a linear scan touches one block per K elements and runs close to
+	array speed, where LinkedList takes a cache miss per element.
+
+	insert() into a full block splits it in two halves. erase() closes
+	the gap in its block, and a block other than the first or the last
+	that falls under half full takes the next block in whole when both
+	fit in one, else borrows its first element. Every inner block stays
+	at least half full, so memory is at most twice the elements.
+
+	Same interface as LinkedList. Positions are a block and an index
+	instead of a Node pointer and are invalidated by any insert or erase.
+**/
+
+#include <iostream> // cout
+#include <stdexcept> // std::runtime_error
+
+namespace unrolled_detail {
+
+	// a cache line of elements, at least 4 per block
+	template <class NodeType>
+	constexpr int capacity() { return 64 / sizeof(NodeType) < 4 ? 4 : static_cast<int>(64 / sizeof(NodeType)); }
+}
+
+template <class NodeType, int K>
+struct alignas(64) UnrolledNode {
+	NodeType data[K];
+	int count = 0;
+	UnrolledNode<NodeType, K>* next = nullptr;
+	UnrolledNode<NodeType, K>* prev = nullptr;
+};
+
+template <class NodeType, int K = unrolled_detail::capacity<NodeType>()>
+class UnrolledLinkedList {
+public:
+	typedef UnrolledNode<NodeType, K> Block;
+	struct Position {
+		Block* block; // nullptr is one past the last element
+		int index;
+	};
+
+	UnrolledLinkedList() {}
+	UnrolledLinkedList(const UnrolledLinkedList& that);
+	UnrolledLinkedList& operator=(const UnrolledLinkedList& that);
+	~UnrolledLinkedList();
+
+	void Display();
+	int size() { return n; }
+	bool empty() { return n == 0; }
+	void insertFront(const NodeType& item);
+	NodeType removeFront();
+	void insertBack(const NodeType& item);
+	NodeType removeBack();
+	void insert(Position pos, const NodeType& item); // before pos
+	NodeType erase(Position pos);
+	NodeType getHead() { return head->data[0]; }
+	NodeType getTail() { return tail->data[tail->count - 1]; }
+	void removeDup();
+	void clear(); // remove all elements
+
+	Position begin() { return Position{ head, 0 }; }
+	// f(element) for every element, front to back
+	template <class F>
+	void forEach(F f);
+	// first smallest element under isLess, only valid if !empty()
+	template <class C>
+	Position minElement(C isLess);
+private:
+	Block* head = nullptr;
+	Block* tail = nullptr;
+	int n = 0; // element counter
+
+	Block* linkAfter(Block* b); // new empty block after b, at the front if b is nullptr
+	void unlink(Block* b);
+	void rebalance(Block* b);
+	void copyFrom(const UnrolledLinkedList& that);
+};
+
+// copy ctor
+template <class NodeType, int K>
+UnrolledLinkedList<NodeType, K>::UnrolledLinkedList(const UnrolledLinkedList<NodeType, K>& that)
+{
+	copyFrom(that);
+}
+
+// copy assignment
+template <class NodeType, int K>
+UnrolledLinkedList<NodeType, K>& UnrolledLinkedList<NodeType, K>::operator=(const UnrolledLinkedList<NodeType, K>& that)
+{
+	if (this == &that) // check for self-assignment
+		return *this;
+	if (!empty())
+		clear();
+	copyFrom(that);
+	return *this;
+}
+
+// dtor
+template <class NodeType, int K>
+UnrolledLinkedList<NodeType, K>::~UnrolledLinkedList()
+{
+	while (head) {
+		Block* p = head;
+		head = head->next;
+		delete p;
+	}
+}
+
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::copyFrom(const UnrolledLinkedList<NodeType, K>& that)
+{
+	for (Block* p = that.head; p; p = p->next) {
+		Block* b = linkAfter(tail);
+		for (int i = 0; i < p->count; i++)
+			b->data[i] = p->data[i];
+		b->count = p->count;
+	}
+	n = that.n;
+}
+
+// display
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::Display()
+{
+	for (Block* p = head; p; p = p->next)
+		for (int i = 0; i < p->count; i++)
+			std::cout << p->data[i] << " ";
+}
+
+template <class NodeType, int K>
+typename UnrolledLinkedList<NodeType, K>::Block* UnrolledLinkedList<NodeType, K>::linkAfter(Block* b)
+{
+	Block* t = new Block;
+	t->prev = b;
+	t->next = b ? b->next : head;
+	if (t->next)
+		t->next->prev = t;
+	else
+		tail = t;
+	if (b)
+		b->next = t;
+	else
+		head = t;
+	return t;
+}
+
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::unlink(Block* b)
+{
+	if (b->prev)
+		b->prev->next = b->next;
+	else
+		head = b->next;
+	if (b->next)
+		b->next->prev = b->prev;
+	else
+		tail = b->prev;
+	delete b;
+}
+
+// insert_front
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::insertFront(const NodeType& item)
+{
+	if (head == nullptr || head->count == K)
+		linkAfter(nullptr); // a fresh front block instead of splitting a full one
+	insert(Position{ head, 0 }, item);
+}
+
+// insert_back
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::insertBack(const NodeType& item)
+{
+	if (tail == nullptr || tail->count == K)
+		linkAfter(tail);
+	tail->data[tail->count++] = item;
+	n++;
+}
+
+// insert before pos, a full block is split in two halves first
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::insert(Position pos, const NodeType& item)
+{
+	if (pos.block == nullptr) {
+		insertBack(item);
+		return;
+	}
+	Block* b = pos.block;
+	int i = pos.index;
+	if (b->count == K) { // split
+		Block* t = linkAfter(b);
+		int half = K / 2;
+		for (int j = half; j < K; j++)
+			t->data[j - half] = b->data[j];
+		t->count = K - half;
+		b->count = half;
+		if (i > half) {
+			b = t;
+			i -= half;
+		}
+	}
+	for (int j = b->count; j > i; j--)
+		b->data[j] = b->data[j - 1];
+	b->data[i] = item;
+	b->count++;
+	n++;
+}
+
+// remove_front
+template <class NodeType, int K>
+NodeType UnrolledLinkedList<NodeType, K>::removeFront()
+{
+	if (empty())
+		throw std::runtime_error("Error: Empty List");
+	return erase(Position{ head, 0 });
+}
+
+// remove_back
+template <class NodeType, int K>
+NodeType UnrolledLinkedList<NodeType, K>::removeBack()
+{
+	if (empty())
+		throw std::runtime_error("Error: Empty List");
+	return erase(Position{ tail, tail->count - 1 });
+}
+
+// erase
+template <class NodeType, int K>
+NodeType UnrolledLinkedList<NodeType, K>::erase(Position pos)
+{
+	if (empty())
+		throw std::runtime_error("Error: Empty List");
+	Block* b = pos.block;
+	NodeType x = b->data[pos.index];
+	for (int j = pos.index + 1; j < b->count; j++)
+		b->data[j - 1] = b->data[j];
+	b->count--;
+	n--;
+	if (b->count == 0)
+		unlink(b);
+	else
+		rebalance(b);
+	return x;
+}
+
+// keep inner blocks at least half full : merge with the next block if
+// both fit in one, else borrow its first element
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::rebalance(Block* b)
+{
+	if (b == head || b == tail || b->count >= K / 2)
+		return;
+	Block* t = b->next;
+	if (b->count + t->count <= K) {
+		for (int j = 0; j < t->count; j++)
+			b->data[b->count + j] = t->data[j];
+		b->count += t->count;
+		unlink(t);
+	}
+	else {
+		b->data[b->count++] = t->data[0];
+		for (int j = 1; j < t->count; j++)
+			t->data[j - 1] = t->data[j];
+		t->count--;
+	}
+}
+
+// clear
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::clear()
+{
+	if (empty())
+		throw std::runtime_error("Error: Empty List");
+	while (head) {
+		Block* p = head;
+		head = head->next;
+		delete p;
+	}
+	tail = nullptr;
+	n = 0;
+}
+
+// remove_dup : keeps the first of every value and packs the survivors
+// into full blocks, trailing blocks are freed
+template <class NodeType, int K>
+void UnrolledLinkedList<NodeType, K>::removeDup()
+{
+	if (empty())
+		return;
+	Block* wb = head; // write cursor, never ahead of the read cursor
+	int wi = 0;
+	n = 0;
+	for (Block* rb = head; rb; rb = rb->next) {
+		for (int ri = 0; ri < rb->count; ri++) {
+			NodeType e = rb->data[ri];
+			bool dup = false;
+			for (Block* kb = head; kb && !dup; kb = kb->next) {
+				int end = kb == wb ? wi : kb->count;
+				for (int j = 0; j < end && !dup; j++)
+					dup = kb->data[j] == e;
+				if (kb == wb)
+					break;
+			}
+			if (dup)
+				continue;
+			if (wi == K) {
+				wb->count = K;
+				wb = wb->next;
+				wi = 0;
+			}
+			wb->data[wi++] = e;
+			n++;
+		}
+	}
+	wb->count = wi;
+	while (wb->next)
+		unlink(wb->next);
+}
+
+template <class NodeType, int K>
+template <class F>
+void UnrolledLinkedList<NodeType, K>::forEach(F f)
+{
+	for (Block* p = head; p; p = p->next)
+		for (int i = 0; i < p->count; i++)
+			f(p->data[i]);
+}
+
+template <class NodeType, int K>
+template <class C>
+typename UnrolledLinkedList<NodeType, K>::Position UnrolledLinkedList<NodeType, K>::minElement(C isLess)
+{
+	Position m{ head, 0 };
+	for (Block* p = head; p; p = p->next) {
+		int best = 0; // scan the block on its own, no branch on the block pointer
+		for (int i = 1; i < p->count; i++)
+			if (isLess(p->data[i], p->data[best]))
+				best = i;
+		if (isLess(p->data[best], m.block->data[m.index]))
+			m = Position{ p, best };
+	}
+	return m;
+}
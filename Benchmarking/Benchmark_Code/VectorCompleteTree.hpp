@@ -1,6 +1,18 @@
 // Adapted from Goodrich
 #pragma once
 #include <vector>
+#include <iostream> // std::cout
+#include <cstddef> // size_t
+#include <new> // std::align_val_t
+#include <type_traits> // std::enable_if
+#include <utility> // std::move
+// SSE4.1 child scan for int heaps with D a multiple of 4. GCC and Clang
+// define __SSE4_1__ under -msse4.1 or -march=native; MSVC never does, but
+// defines __AVX__ / __AVX2__ under /arch:AVX and /arch:AVX2, which imply it
+#if defined(__SSE4_1__) || defined(__AVX__) || defined(__AVX2__)
+#define HEAP_SIMD_SSE41 1
+#include <smmintrin.h> // _mm_min_epi32
+#endif
 
 //functor
 template <class NodeType>
@@ -11,44 +23,133 @@ public:
     }
 };
 
-template <class NodeType>
+// std::vector storage starting on a 64-byte cache line
+template <class T>
+class CacheAlignedAllocator {
+public:
+    typedef T value_type;
+    static const size_t ALIGN = 64;
+
+    CacheAlignedAllocator() {}
+    template <class U> CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGN))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(ALIGN)); }
+
+    template <class U> bool operator == (const CacheAlignedAllocator<U>&) const { return true; }
+    template <class U> bool operator != (const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+namespace tree_detail {
+
+    // offset of the smallest of count children, the first one on ties
+    template <class NodeType, class C, int D, class Enable = void>
+    struct ChildMin {
+        static int first(const NodeType* c, int count, const C& isLess)
+        {
+            int best = 0;
+            for (int j = 1; j < count; j++)
+                if (isLess(c[j], c[best]))
+                    best = j;
+            return best;
+        }
+    };
+
+#ifdef HEAP_SIMD_SSE41
+    // a full group of int children is 16-byte aligned, reduce it 4 lanes at a time
+    template <int D>
+    struct ChildMin<int, Compare<int>, D, typename std::enable_if<D % 4 == 0>::type> {
+        static int first(const int* c, int count, const Compare<int>& isLess)
+        {
+            if (count < D)
+                return ChildMin<int, Compare<int>, D, char>::first(c, count, isLess);
+            __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(c));
+            for (int j = 4; j < D; j += 4)
+                m = _mm_min_epi32(m, _mm_load_si128(reinterpret_cast<const __m128i*>(c + j)));
+            m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+            m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1))); // min in every lane
+            for (int j = 0;; j += 4) {
+                __m128i eq = _mm_cmpeq_epi32(m, _mm_load_si128(reinterpret_cast<const __m128i*>(c + j)));
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+                if (mask) {
+                    int b = 0;
+                    while (!((mask >> b) & 1))
+                        b++;
+                    return j + b;
+                }
+            }
+        }
+    };
+#endif
+}
+
+// D-ary complete tree, 1-indexed: the children of node i are
+// D(i - 1) + 2 ... D(i - 1) + D + 1 (2i and 2i + 1 when D = 2).
+// Node i is stored at i + D - 2, so with the cache-aligned array every
+// group of siblings starts on a multiple of D and, when D * sizeof(NodeType)
+// divides 64, sits in a single cache line.
+template <class NodeType, int D = 2>
 class VectorCompleteTree {
+    static_assert(D >= 2, "VectorCompleteTree needs at least two children per node");
 public:
-    VectorCompleteTree() : sorted(1) {} // ctor
+    VectorCompleteTree() : sorted(D - 1) {} // ctor
 
     // iterator
-    typedef typename std::vector<NodeType>::iterator Position;
-
-    int size() const { return sorted.size() - 1; }
-    Position left(const Position& p) { return pos(2 * idx(p)); }
-    Position right(const Position& p) { return pos(2 * idx(p) + 1); }
-    Position parent(const Position& p) { return pos(idx(p) / 2); }
-    bool hasLeft(const Position& p) const { return 2 * idx(p) <= size(); }
-    bool hasRight(const Position& p) const { return 2 * idx(p) + 1 <= size(); }
+    typedef typename std::vector<NodeType, CacheAlignedAllocator<NodeType>>::iterator Position;
+
+    int size() const { return sorted.size() - (D - 1); }
+    // left and right are the first two children
+    Position left(const Position& p) { return child(p, 0); }
+    Position right(const Position& p) { return child(p, 1); }
+    Position child(const Position& p, int j) { return pos(D * (idx(p) - 1) + 2 + j); }
+    Position parent(const Position& p) { return pos((idx(p) - 2) / D + 1); }
+    bool hasLeft(const Position& p) const { return D * (idx(p) - 1) + 2 <= size(); }
+    bool hasRight(const Position& p) const { return D * (idx(p) - 1) + 3 <= size(); }
     bool isRoot(const Position& p) const { return idx(p) == 1; }
+    // root is depth 0
+    int depth(const Position& p) const
+    {
+        int d = 0;
+        if (D == 2)
+            for (int i = idx(p); i > 1; i >>= 1)
+                d++;
+        else
+            for (int i = idx(p); i > 1; i = (i - 2) / D + 1)
+                d++;
+        return d;
+    }
     Position root() { return pos(1); }
     Position last() { return pos(size()); }
+    // smallest child of p under isLess, p must have a left child
+    template <class C>
+    Position minChild(const Position& p, const C& isLess)
+    {
+        int first = D * (idx(p) - 1) + 2;
+        int count = size() - first + 1 < D ? size() - first + 1 : D;
+        return pos(first + tree_detail::ChildMin<NodeType, C, D>::first(&*pos(first), count, isLess));
+    }
     void addLast(const NodeType& e) { sorted.push_back(e); }
+    void addLast(NodeType&& e) { sorted.push_back(std::move(e)); }
     void removeLast() { sorted.pop_back(); }
     void swap(const Position& p, const Position& q)
     {
-        NodeType e = *q;
-        *q = *p;
-        *p = e;
+        NodeType e = std::move(*q);
+        *q = std::move(*p);
+        *p = std::move(e);
     }
     void display()
     {
-        size_t sz = size();
-        for (size_t i = 1; i <= sz; i++) {
-            std::cout << "Elem[" << i << "]: " << sorted[i];
+        int sz = size();
+        for (int i = 1; i <= sz; i++) {
+            std::cout << "Elem[" << i << "]: " << *pos(i);
             if (i < sz)
                 std::cout << ", ";
         }
     }
 protected:
-    Position pos(int i) { return sorted.begin() + i; }
-    int idx(const Position& p) const { return p - sorted.begin(); }
+    Position pos(int i) { return sorted.begin() + (i + D - 2); }
+    int idx(const Position& p) const { return static_cast<int>(p - sorted.begin()) - (D - 2); }
 
 private:
-    std::vector<NodeType> sorted;
-};
\ No newline at end of file
+    std::vector<NodeType, CacheAlignedAllocator<NodeType>> sorted;
+};
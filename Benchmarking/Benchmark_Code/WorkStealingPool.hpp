@@ -0,0 +1,203 @@
+#pragma once
+/**
+	Description :
+	Work-Stealing Thread Pool for Fork/Join Tasks
+
+	Every worker owns a deque of tasks. A worker pushes and pops its own
+	tasks at the back (LIFO, the most recent task is the hottest in cache)
+	and idle workers steal from the front of a random victim (FIFO, the
+	oldest task is usually the biggest piece of work).
+
+	Tasks are grouped in a TaskGroup; wait() on a group does not block,
+	the waiting thread keeps running and stealing tasks until the group is
+	done, so nested fork/join does not run out of threads. The thread that
+	calls run() takes part as worker 0.
+
+	Usage :
+		WorkStealingPool pool(8);
+		pool.run([&]() {
+			TaskGroup g;
+			pool.spawn(g, [&]() { left(); });
+			right();
+			pool.wait(g);
+		});
+**/
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <deque> // std::deque
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+class TaskGroup
+{
+public:
+	TaskGroup() : pending(0) {}
+	bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+private:
+	friend class WorkStealingPool;
+	std::atomic<long> pending;
+};
+
+class WorkStealingPool
+{
+public:
+	// threads counts the caller of run(), 0 uses every core
+	explicit WorkStealingPool(unsigned threads = 0);
+	~WorkStealingPool();
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	unsigned threads() const { return static_cast<unsigned>(queues.size()); }
+	// run root on the calling thread with the workers awake, returns when it does
+	void run(const std::function<void()>& root);
+	// queue task on the calling worker's deque, only from inside run()
+	void spawn(TaskGroup& group, std::function<void()> task);
+	// execute or steal tasks until every task of group has finished
+	void wait(TaskGroup& group);
+private:
+	struct Task {
+		std::function<void()> fn;
+		TaskGroup* group;
+	};
+
+	struct Queue {
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+
+	void worker(unsigned id);
+	bool popOwn(unsigned id, Task& t);
+	bool steal(unsigned id, Task& t);
+	void execute(Task& t);
+	static unsigned& self(); // this thread's worker id
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> helpers;
+	std::atomic<bool> running;	// a run() is in progress, workers look for tasks
+	std::atomic<bool> stopping;
+	std::mutex sleepLock;
+	std::condition_variable wake;
+};
+
+inline unsigned& WorkStealingPool::self()
+{
+	static thread_local unsigned id = 0;
+	return id;
+}
+
+inline WorkStealingPool::WorkStealingPool(unsigned threads) : running(false), stopping(false)
+{
+	if (threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if (threads == 0)
+		threads = 1;
+	for (unsigned i = 0; i < threads; i++)
+		queues.emplace_back(new Queue);
+	for (unsigned i = 1; i < threads; i++)
+		helpers.emplace_back(&WorkStealingPool::worker, this, i);
+}
+
+inline WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& t : helpers)
+		t.join();
+}
+
+inline void WorkStealingPool::run(const std::function<void()>& root)
+{
+	self() = 0;
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		running = true;
+	}
+	wake.notify_all();
+	root();
+	running = false;
+}
+
+inline void WorkStealingPool::spawn(TaskGroup& group, std::function<void()> task)
+{
+	group.pending.fetch_add(1, std::memory_order_relaxed);
+	Queue& q = *queues[self()];
+	std::lock_guard<std::mutex> guard(q.lock);
+	q.tasks.push_back(Task{ std::move(task), &group });
+}
+
+inline void WorkStealingPool::wait(TaskGroup& group)
+{
+	unsigned id = self();
+	Task t;
+	while (!group.done()) {
+		if (popOwn(id, t) || steal(id, t))
+			execute(t);
+		else
+			std::this_thread::yield();
+	}
+}
+
+inline bool WorkStealingPool::popOwn(unsigned id, Task& t)
+{
+	Queue& q = *queues[id];
+	std::lock_guard<std::mutex> guard(q.lock);
+	if (q.tasks.empty())
+		return false;
+	t = std::move(q.tasks.back());
+	q.tasks.pop_back();
+	return true;
+}
+
+inline bool WorkStealingPool::steal(unsigned id, Task& t)
+{
+	// xorshift victim choice, each thread its own stream
+	static thread_local unsigned seed = 2463534242u + id * 7919u;
+	unsigned n = threads();
+	for (unsigned tries = 0; tries < n; tries++) {
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		unsigned victim = seed % n;
+		if (victim == id)
+			continue;
+		Queue& q = *queues[victim];
+		std::unique_lock<std::mutex> guard(q.lock, std::try_to_lock);
+		if (!guard.owns_lock() || q.tasks.empty())
+			continue;
+		t = std::move(q.tasks.front());
+		q.tasks.pop_front();
+		return true;
+	}
+	return false;
+}
+
+inline void WorkStealingPool::execute(Task& t)
+{
+	t.fn();
+	t.group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+inline void WorkStealingPool::worker(unsigned id)
+{
+	self() = id;
+	Task t;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [this]() { return running || stopping; });
+			if (stopping)
+				return;
+		}
+		while (running) {
+			if (popOwn(id, t) || steal(id, t))
+				execute(t);
+			else
+				std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,127 @@
+/**
+	Description :
+	Generates NoFlyIndex.hpp, the no-fly list compiled into the binary
+	as a perfect hash set (PerfectHash.hpp)
+
+	Usage : GenerateNoFlyIndex [noFlyList] [header]
+	        defaults fakeNoFlyList.txt and NoFlyIndex.hpp, same working
+	        directory as the No-Fly List demo in Main.cpp
+
+	The IDs are hashed into buckets of 4 on average, and the buckets,
+	largest first, each get the smallest displacement that puts all
+	their IDs into free slots. The table has 25% spare slots, so most
+	buckets settle within a few tries; if a bucket runs out of
+	displacements the table grows by one slot and the search restarts.
+**/
+
+#include "PerfectHash.hpp"
+
+#include <algorithm> // std::sort, std::unique, std::stable_sort
+#include <fstream> // file I/O
+#include <iostream> // std::cout, std::cerr
+#include <string> // std::string
+#include <vector> // std::vector
+
+// slot of every key in a table of m slots and r buckets, false if some bucket does not fit
+bool place(const std::vector<int>& keys, int m, int r, std::vector<int>& table, std::vector<int>& displacement);
+
+int main(int argc, char* argv[]) {
+	std::string inPath = argc > 1 ? argv[1] : "fakeNoFlyList.txt";
+	std::string outPath = argc > 2 ? argv[2] : "NoFlyIndex.hpp";
+
+	std::ifstream in(inPath);
+	if (!in.is_open()) {
+		std::cerr << "File open error " << inPath << std::endl;
+		return 1;
+	}
+	std::vector<int> keys;
+	int iD; std::string firstName; std::string lastName;
+	while (in >> iD >> firstName >> lastName)
+		keys.push_back(iD);
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	if (keys.empty()) {
+		std::cerr << "no IDs in " << inPath << std::endl;
+		return 1;
+	}
+
+	int n = static_cast<int>(keys.size());
+	int r = (n + 3) / 4;
+	int m = n + (n + 3) / 4;
+	std::vector<int> table, displacement;
+	while (!place(keys, m, r, table, displacement))
+		m++;
+
+	std::ofstream out(outPath);
+	if (!out.is_open()) {
+		std::cerr << "File open error " << outPath << std::endl;
+		return 1;
+	}
+	out << "// Generated by GenerateNoFlyIndex.cpp from " << inPath << ", do not edit\n"
+		<< "// " << n << " IDs, " << m << " slots, " << r << " buckets\n"
+		<< "#pragma once\n"
+		<< "#include \"PerfectHash.hpp\"\n\n"
+		<< "constexpr StaticPerfectSet<" << m << ", " << r << "> NO_FLY_INDEX = {\n\t{";
+	for (int i = 0; i < m; i++) {
+		out << (i % 10 == 0 ? "\n\t\t" : " ");
+		if (table[i] == chd::EMPTY)
+			out << "INT_MIN";
+		else
+			out << table[i];
+		out << (i + 1 < m ? "," : "");
+	}
+	out << "\n\t},\n\t{";
+	for (int i = 0; i < r; i++)
+		out << (i % 16 == 0 ? "\n\t\t" : " ") << displacement[i] << (i + 1 < r ? "," : "");
+	out << "\n\t}\n};\n"
+		<< "static_assert(NO_FLY_INDEX.search(" << keys.front() << ") && !NO_FLY_INDEX.search("
+		<< keys.front() - 1 << "), \"no-fly index does not match its IDs\");\n\n"
+		<< "// the no-fly list as of generation, same search() as BinarySearchTree\n"
+		<< "class StaticNoFlyList {\n"
+		<< "public:\n"
+		<< "\tconstexpr bool search(int key) const { return NO_FLY_INDEX.search(key); }\n"
+		<< "\tconstexpr int returnCount() const { return " << n << "; }\n"
+		<< "};\n";
+	std::cout << outPath << " : " << n << " IDs, " << m << " slots, " << r << " buckets" << std::endl;
+	return 0;
+}
+
+bool place(const std::vector<int>& keys, int m, int r, std::vector<int>& table, std::vector<int>& displacement) {
+	std::vector<std::vector<int>> buckets(r);
+	for (int k : keys)
+		buckets[chd::bucket(k, r)].push_back(k);
+	std::vector<int> order(r);
+	for (int b = 0; b < r; b++)
+		order[b] = b;
+	std::stable_sort(order.begin(), order.end(),
+		[&](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+
+	table.assign(m, chd::EMPTY);
+	displacement.assign(r, 0);
+	std::vector<int> slots;
+	for (int b : order) {
+		if (buckets[b].empty())
+			break; // the rest are empty too
+		bool placed = false;
+		for (int d = 0; d <= 0xFFFF && !placed; d++) {
+			slots.clear();
+			placed = true;
+			for (int k : buckets[b]) {
+				int s = static_cast<int>(chd::slot(k, d, m));
+				if (table[s] != chd::EMPTY || std::find(slots.begin(), slots.end(), s) != slots.end()) {
+					placed = false;
+					break;
+				}
+				slots.push_back(s);
+			}
+			if (placed) {
+				displacement[b] = d;
+				for (size_t i = 0; i < slots.size(); i++)
+					table[slots[i]] = buckets[b][i];
+			}
+		}
+		if (!placed)
+			return false;
+	}
+	return true;
+}
@@ -8,12 +8,20 @@
 	Demos : 
 	1. Benchmark Insertion
 	2. Airline No-Fly List 
+	3. The same No-Fly List compiled in as a perfect hash set
+	   (NoFlyIndex.hpp, regenerate with GenerateNoFlyIndex.cpp
+	   whenever fakeNoFlyList.txt changes), checked against the BST
 
 	Note: Hashing would be a better match than BST for this 
 	particular application
+
+	Build with TRACK_ALLOCATIONS defined to also report the heap
+	bytes per key of each insertion trial (AllocTracker.hpp)
 **/
 
 #include "BST.hpp" 
+#include "NoFlyIndex.hpp"
+#include "../../Benchmarking/Benchmark_Code/AllocTracker.hpp"
 
 #include <iostream> // std::cout
 #include <fstream> // file I/O
@@ -25,12 +33,16 @@
 #include <random> // srand() , rand()
 #include <chrono> // high_resolution_clock
 
-void calculateBSTInsertionTime(std::vector<std::tuple<int, double, double>> &trials, int n);
-void printBSTInsertionTrialTimes(const std::vector<std::tuple<int, double, double>>& trials);
+void calculateBSTInsertionTime(std::vector<std::tuple<int, double, double, double, double>> &trials, int n);
+void printBSTInsertionTrialTimes(const std::vector<std::tuple<int, double, double, double, double>>& trials);
 
 void populateBSTWithNoFlyData(BinarySearchTree<int, std::string>& noFlyList);
 void populateVectorWithPassengerManifest(std::vector<std::pair<int, std::string>>& passengerList);
-void verifyPassengers(BinarySearchTree<int, std::string>& noFlyList, std::vector<std::pair<int, std::string>> passengerList);
+// NoFlyList is anything with search(id), BinarySearchTree or StaticNoFlyList
+template <class NoFlyList>
+void verifyPassengers(NoFlyList& noFlyList, std::vector<std::pair<int, std::string>> passengerList);
+void checkStaticNoFlyList(BinarySearchTree<int, std::string>& noFlyList, StaticNoFlyList& staticNoFlyList,
+	const std::vector<std::pair<int, std::string>>& passengerList);
 
 
 
@@ -131,7 +143,7 @@ int main() {
 	std::cout << "\n\t\t\t---BST Insertion Times--- " << std::endl;
 
 	// a vector of times can be used to store many trials
-	std::vector<std::tuple<int, double, double>> trials; 	
+	std::vector<std::tuple<int, double, double, double, double>> trials; 	
 	/*
 		 Helper function to test best/worst case BST insertion time
 
@@ -159,12 +171,57 @@ int main() {
 	// check if any passengers on departing flight are on no fly list
 	verifyPassengers(noFlyList, passengerManifest);
 
+	std::cout << "\n--------------------------------------------------------------------------------------" << std::endl;
+	std::cout << "Testing Static No-Fly Index : Perfect Hash Compiled In vs BST" << std::endl;
+	std::cout << "--------------------------------------------------------------------------------------" << std::endl;
+
+	// nothing to load, the index is a constant in the binary
+	StaticNoFlyList staticNoFlyList;
+	verifyPassengers(staticNoFlyList, passengerManifest);
+	checkStaticNoFlyList(noFlyList, staticNoFlyList, passengerManifest);
+
 	return 0;
 }
 
+// every ID the files can hold (5 digits) must get the same answer from
+// both lists, then both are timed over the same lookups
+void checkStaticNoFlyList(BinarySearchTree<int, std::string>& noFlyList, StaticNoFlyList& staticNoFlyList,
+	const std::vector<std::pair<int, std::string>>& passengerList) {
+	const int IDS = 100000;
+	int mismatches = 0, found = 0;
+	for (int id = 0; id < IDS; id++) {
+		bool inTree = noFlyList.search(id);
+		found += inTree;
+		if (inTree != staticNoFlyList.search(id)) {
+			std::cerr << "ID " << id << " : BST " << inTree << ", static index " << !inTree << std::endl;
+			mismatches++;
+		}
+	}
+	for (auto& p : passengerList)
+		if (noFlyList.search(p.first) != staticNoFlyList.search(p.first))
+			mismatches++;
+	std::cout << "\nIDs 0 to " << IDS - 1 << " and the manifest checked : " << mismatches << " mismatches, "
+		<< found << " of " << staticNoFlyList.returnCount() << " no-fly IDs found by both" << std::endl;
+
+	int hits = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int id = 0; id < IDS; id++)
+		hits += noFlyList.search(id);
+	auto stop = std::chrono::high_resolution_clock::now();
+	std::cout << "BST lookups          : " << std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count()
+		<< " microseconds for " << IDS << std::endl;
+	start = std::chrono::high_resolution_clock::now();
+	for (int id = 0; id < IDS; id++)
+		hits += staticNoFlyList.search(id);
+	stop = std::chrono::high_resolution_clock::now();
+	std::cout << "Perfect hash lookups : " << std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count()
+		<< " microseconds for " << IDS << (hits == 2 * found ? "" : " (hit counts differ)") << std::endl;
+}
+
 // better to make this a const BST and define a search() method for
 // const qualified types
-void verifyPassengers(BinarySearchTree<int, std::string>& noFlyList, std::vector<std::pair<int, std::string>> passengerList) {
+template <class NoFlyList>
+void verifyPassengers(NoFlyList& noFlyList, std::vector<std::pair<int, std::string>> passengerList) {
 	// print header
 	std::cout << std::endl;
 	std::cout << "---Verify Passengers Before Takeoff---" << std::endl;
@@ -229,34 +286,43 @@ void populateBSTWithNoFlyData(BinarySearchTree<int, std::string>& noFlyList) {
 	myFile.close();
 }
 
-void printBSTInsertionTrialTimes(const std::vector<std::tuple<int, double, double>>& trials) {
+void printBSTInsertionTrialTimes(const std::vector<std::tuple<int, double, double, double, double>>& trials) {
 	// print the results from each trial
 	int n = 1;
 	//for (auto it = trials.begin(); it != trials.end(); ++it) {
 	for (auto& t : trials) {
 		{
 			std::cout << "Sample Size: " << "\t" << std::get<0>(t) << "\t" <<" Random:"  << "\t" << std::get<1>(t) << "\t"
-				<< " Sequential: " << "\t" << std::get<2>(t) << std::endl;
+				<< " Sequential: " << "\t" << std::get<2>(t);
+			if (AllocCounters().available())
+				std::cout << "\t" << " Bytes/Key Random: " << std::get<3>(t) << "\t" << " Bytes/Key Sequential: " << std::get<4>(t);
+			std::cout << std::endl;
 		}
 	}
 }
 
-void calculateBSTInsertionTime(std::vector<std::tuple<int, double, double>>& trials, int n) {
+void calculateBSTInsertionTime(std::vector<std::tuple<int, double, double, double, double>>& trials, int n) {
 	/*
 			 ---Best Case BST Insertion Time--- 
 		+	Inserted Keys Have Random Values
 	*/
 
-	// params: sampleSize, worstCaseInsertionTime, bestCaseInsertionTime
-	std::tuple<int, double, double> times;
+	// params: sampleSize, worstCaseInsertionTime, bestCaseInsertionTime,
+	//		   bytes per key (random), bytes per key (sequential)
+	std::tuple<int, double, double, double, double> times;
+	AllocCounters allocs; // live only with TRACK_ALLOCATIONS
 
 	BinarySearchTree <int, std::string> bstGood;
 
 	// time the insertion
+	allocs.start();
 	auto start = std::chrono::high_resolution_clock::now();
 	for (int i = 0; i < n; i++)
 		bstGood.insert(std::rand() % n + 1, "r");
 	auto stop = std::chrono::high_resolution_clock::now();
+	allocs.stop();
+	// one TreeNode per distinct key
+	std::get<3>(times) = bstGood.returnCount() ? static_cast<double>(allocs.peak()) / bstGood.returnCount() : 0;
 	// store the sample size
 	std::get<0>(times) = n;
 	// store the time
@@ -279,11 +345,14 @@ void calculateBSTInsertionTime(std::vector<std::tuple<int, double, double>>& tri
 	*/
 	BinarySearchTree <int, std::string > bstBad;
 	// time the insertion
+	allocs.start();
 	start = std::chrono::high_resolution_clock::now();
 	for (int i = 0; i < n; i++) {
 		bstBad.insert(i, "s");
 	}
 	stop = std::chrono::high_resolution_clock::now();
+	allocs.stop();
+	std::get<4>(times) = n ? static_cast<double>(allocs.peak()) / n : 0;
 	// store the time
 	std::get<2>(times) = std::chrono::duration_cast
 		<std::chrono::microseconds>(stop - start).count();
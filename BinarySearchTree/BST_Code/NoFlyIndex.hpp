@@ -0,0 +1,37 @@
+// Generated by GenerateNoFlyIndex.cpp from fakeNoFlyList.txt, do not edit
+// 125 IDs, 157 slots, 32 buckets
+#pragma once
+#include "PerfectHash.hpp"
+
+constexpr StaticPerfectSet<157, 32> NO_FLY_INDEX = {
+	{
+		34826, 69179, 34226, 56392, 55332, 22724, INT_MIN, 91351, INT_MIN, 35390,
+		INT_MIN, INT_MIN, 45417, 41213, 94348, 68359, 23286, INT_MIN, 51866, INT_MIN,
+		44705, 30499, 29288, 17828, INT_MIN, 68527, 38262, 90917, 73672, 77350,
+		27814, 90893, INT_MIN, INT_MIN, 53676, 21422, 51852, INT_MIN, 84046, 44689,
+		INT_MIN, 16951, 77833, 35638, INT_MIN, 59753, 26289, 67130, 32861, 12074,
+		INT_MIN, 73815, 44821, 41688, INT_MIN, 12014, 30222, 65646, 32728, 66933,
+		78867, INT_MIN, INT_MIN, 62990, 54709, 71527, 52379, 82617, 84590, 25737,
+		INT_MIN, 11330, 67500, 78731, INT_MIN, INT_MIN, 82386, 12562, 73933, 57880,
+		75822, 81214, 65290, 17988, 32575, 58261, 89524, 97830, 64613, 87551,
+		30702, INT_MIN, 37773, 69680, 71034, 25533, 16431, INT_MIN, 73664, 15875,
+		INT_MIN, 98469, 70029, 14245, 86872, 54399, 93442, INT_MIN, 37254, 40915,
+		99297, INT_MIN, 32271, 10060, 17753, 63725, INT_MIN, INT_MIN, 52439, 49382,
+		60905, 81060, INT_MIN, 90424, INT_MIN, 88649, 50844, 96254, INT_MIN, 29792,
+		15809, 51379, 45403, INT_MIN, 17514, 86161, 73287, 43592, 25900, 38253,
+		16729, INT_MIN, INT_MIN, 11418, 52464, 62020, 42919, 40123, 58703, 66689,
+		16815, 97763, 11253, 78993, 46845, 52614, 27730
+	},
+	{
+		0, 4, 6, 1, 11, 4, 2, 1, 14, 49, 5, 6, 6, 5, 27, 4,
+		8, 2, 0, 11, 5, 5, 47, 0, 1, 23, 6, 14, 7, 0, 13, 0
+	}
+};
+static_assert(NO_FLY_INDEX.search(10060) && !NO_FLY_INDEX.search(10059), "no-fly index does not match its IDs");
+
+// the no-fly list as of generation, same search() as BinarySearchTree
+class StaticNoFlyList {
+public:
+	constexpr bool search(int key) const { return NO_FLY_INDEX.search(key); }
+	constexpr int returnCount() const { return 125; }
+};
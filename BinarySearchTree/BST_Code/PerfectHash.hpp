@@ -0,0 +1,49 @@
+#pragma once
+/**
+	Description :
+	Static Perfect Hash Set (CHD : Compress, Hash and Displace)
+
+	For a key set fixed at build time. The keys are split into R buckets
+	by one hash, and every bucket gets a displacement d, chosen by the
+	generator, such that hash(key, d) sends each key of the bucket to a
+	slot of its own among M. A lookup reads the bucket's displacement and
+	the one slot it points to, two memory probes and no collision chain,
+	and compares the key stored there to reject keys outside the set.
+
+	Everything is constexpr : GenerateNoFlyIndex.cpp writes the tables
+	as a constant StaticPerfectSet into a header, so the set exists in
+	the binary with nothing to build at startup, and lookups can run at
+	compile time.
+**/
+
+#include <cstdint> // uint64_t, uint16_t
+#include <climits> // INT_MIN
+
+namespace chd {
+
+	constexpr int EMPTY = INT_MIN; // slot no key landed in
+
+	// splitmix64 finalizer over the key and a seed
+	constexpr uint64_t hash(int key, uint64_t seed)
+	{
+		uint64_t z = static_cast<uint32_t>(key) + (seed + 1) * 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	constexpr uint64_t bucket(int key, int buckets) { return hash(key, 0) % buckets; }
+	// seed 0 picks the bucket, displacements start at seed 1
+	constexpr uint64_t slot(int key, int displacement, int slots) { return hash(key, displacement + 1) % slots; }
+}
+
+template <int M, int R> // M slots, R buckets
+struct StaticPerfectSet {
+	int keys[M];
+	uint16_t displacement[R];
+
+	constexpr bool search(int key) const
+	{
+		return key != chd::EMPTY && keys[chd::slot(key, displacement[chd::bucket(key, R)], M)] == key;
+	}
+};